@@ -2,6 +2,8 @@
 import mathanim.objects as objects
 import mathanim.actions as actions
 import mathanim.sequences as sequences
+import mathanim.data as data
+import mathanim.gradients as gradients
 
 # Core classes
 from mathanim.core import Scene, SceneSettings, Animation
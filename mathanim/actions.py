@@ -1,5 +1,7 @@
+import numpy as np
 from colour import Color
 from numbers import Number
+from mathanim import geometry
 from mathanim.utils import Vector2
 from abc import ABC, abstractmethod
 from mathanim.errors import ArgumentError
@@ -192,6 +194,8 @@ class Procedure(Action):
     
     '''
 
+    expensive = True
+
     def __init__(self, duration, func, *func_args):
         '''
         Initializes an instance of :class:`Procedure`.
@@ -220,4 +224,181 @@ class Procedure(Action):
 
         '''
 
-        return self.func(time, *self.func_args)
\ No newline at end of file
+        return self.func(time, *self.func_args)
+
+class Morph(Action):
+    '''
+    Interpolates the vertices of a path from one shape to another.
+
+    :note:
+        The expensive work is done once, when the action is created: both shapes are resampled
+        to a common number of vertices and the vertices of the destination are reordered so that
+        they best correspond to those of the source. Evaluating the morph at a given time is then
+        a single vectorized interpolation of two vertex arrays.
+
+        The morph should be bound to the ``vertices`` attribute of a :class:`mathanim.objects.Path`.
+
+    '''
+
+    def __init__(self, source, destination, duration, vertex_count=None, closed=None, func=None):
+        '''
+        Initializes an instance of :class:`Morph`.
+
+        :param source:
+            The initial shape. This can either be a :class:`mathanim.objects.Path` or an 
+            array-like object of vertices.
+        :param destination:
+            The final shape. This can either be a :class:`mathanim.objects.Path` or an
+            array-like object of vertices.
+        :param duration:
+            The duration of the morph, in seconds.
+        :param vertex_count:
+            The number of vertices to resample both shapes to. Defaults to the number of
+            vertices in the more detailed of the two shapes.
+        :param closed:
+            Indicates whether the shapes are closed. Defaults to whether the source is a closed
+            path (or ``False`` if the source is an array of vertices).
+        :param func:
+            The interpolation function; takes in the initial vertices, destination vertices, and time.
+            Defaults to linear.
+
+        '''
+
+        if closed is None:
+            closed = getattr(source, 'closed', False)
+
+        source = geometry.as_points(getattr(source, 'vertices', source))
+        destination = geometry.as_points(getattr(destination, 'vertices', destination))
+        if len(source) == 0 or len(destination) == 0:
+            raise ArgumentError('Morph action requires non-empty source and destination shapes.')
+
+        if vertex_count is None:
+            vertex_count = max(len(source), len(destination), 2)
+
+        self.closed = closed
+        self.source = geometry.resample(source, vertex_count, closed)
+        self.destination = geometry.align(self.source, geometry.resample(destination, vertex_count, closed), closed)
+        self.func = func or Ramp.linear
+
+        super().__init__(duration)
+
+    def get_value(self, time):
+        '''
+        Gets the vertices of the morph at the specified time.
+
+        :param time:
+            The time, in seconds, relative to the start of the action.
+        :returns:
+            A numpy array of vertices with shape ``(n, 2)``.
+            If the time exceeds the duration of the action, None is returned.
+
+        '''
+
+        if time > self.duration: return None
+
+        t = time / self.duration if self.duration > 0 else 1
+        return self.func(self.source, self.destination, t)
+
+class DataTrack(Action):
+    '''
+    Plays back rows of columnar data over time, interpolating between neighbouring rows.
+
+    :note:
+        Evaluating the track at a given time performs a binary search on the time column and
+        reads only the two rows that surround that time, so the data is never loaded in full.
+
+    '''
+
+    expensive = True
+
+    def __init__(self, source, columns, time_column=None, rows_per_second=1, time_scale=1, 
+                 duration=None, interpolate=True):
+        '''
+        Initializes an instance of :class:`DataTrack`.
+
+        :param source:
+            The :class:`mathanim.data.ColumnarData` to read from. A dictionary of arrays is also accepted.
+        :param columns:
+            The name of the column to play back, or a list of names whose values are stacked.
+        :param time_column:
+            The name of a column containing the (sorted) time of each row. Defaults to ``None``, 
+            meaning that rows are evenly spaced in time (see ``rows_per_second``).
+        :param rows_per_second:
+            The number of rows per second of animation when there is no time column. Defaults to 1.
+        :param time_scale:
+            The number of units of the time column that elapse per second of animation. Defaults to 1.
+        :param duration:
+            The duration of the track, in seconds. Defaults to the time spanned by the data.
+        :param interpolate:
+            Indicates whether values should be linearly interpolated between rows. If ``False``, the
+            value of the most recent row is used. Defaults to ``True``.
+
+        '''
+
+        self.source = source
+        self.columns = columns
+        self.time_column = time_column
+        self.rows_per_second = rows_per_second
+        self.time_scale = time_scale
+        self.interpolate = interpolate
+
+        first = source[columns if isinstance(columns, str) else columns[0]]
+        self._row_count = len(first)
+        if self._row_count == 0:
+            raise ArgumentError('DataTrack requires at least one row of data.')
+
+        if time_column is not None:
+            times = source[time_column]
+            self._start_time = float(times[0])
+            span = (float(times[-1]) - self._start_time) / time_scale
+        else:
+            self._start_time = 0
+            span = (self._row_count - 1) / rows_per_second
+
+        super().__init__(span if duration is None else duration)
+
+    def _row(self, index):
+        '''
+        Reads the row at the specified index.
+
+        '''
+
+        if isinstance(self.columns, str):
+            return np.asarray(self.source[self.columns][index], dtype=np.float64)
+
+        return np.array([self.source[name][index] for name in self.columns], dtype=np.float64)
+
+    def get_value(self, time):
+        '''
+        Gets the value of the track at the specified time.
+
+        :param time:
+            The time, in seconds, relative to the start of the action.
+        :returns:
+            The interpolated value of the column(s): a float for scalar columns, otherwise a numpy array.
+            If the time exceeds the duration of the action, None is returned.
+
+        '''
+
+        if time > self.duration: return None
+
+        if self.time_column is not None:
+            times = self.source[self.time_column]
+            target = self._start_time + time * self.time_scale
+            index = int(np.searchsorted(times, target, side='right')) - 1
+            index = min(max(index, 0), self._row_count - 1)
+
+            t = 0
+            if index + 1 < self._row_count:
+                start, end = float(times[index]), float(times[index + 1])
+                t = (target - start) / (end - start) if end > start else 0
+        else:
+            position = min(max(time * self.rows_per_second, 0), self._row_count - 1)
+            index = min(int(position), self._row_count - 1)
+            t = position - index
+
+        value = self._row(index)
+        if self.interpolate and t > 0 and index + 1 < self._row_count:
+            value = value + (self._row(index + 1) - value) * min(t, 1)
+
+        return float(value) if value.ndim == 0 else value
\ No newline at end of file
@@ -1,14 +1,25 @@
+import os
+import sys
+import math
+import json
+import shutil
+import tempfile
+import subprocess
 import cv2
+import itertools
 import tqdm
 import copy
 import cairo
 import numpy as np
 from colour import Color
 from pathlib import Path
-from mathanim.errors import PathError
-from intervaltree import IntervalTree
-from mathanim.objects import SceneObject
-from mathanim.utils import rgetattr, rsetattr, convert_colour
+from mathanim.errors import PathError, ArgumentError
+from mathanim.spatial import GridIndex
+from intervaltree import Interval, IntervalTree
+from concurrent.futures import ThreadPoolExecutor
+from mathanim import geometry, gradients, raster
+from mathanim.objects import SceneObject, Camera
+from mathanim.utils import Bounds, rgetattr, rsetattr, convert_colour, values_equal
 
 class Animation:
     '''
@@ -115,8 +126,35 @@ class Animation:
 
         '''
 
-        for instance in self.sequence_instances:
-            value = instance.sequence_item.get_value(time)
+        return self.apply(self.evaluate(time), animation_object)
+
+    def evaluate(self, time):
+        '''
+        Evaluates the sequences of this :class:`Animation` without applying them to an object.
+
+        :param time:
+            The time relative to the start of the sequence, in seconds.
+        :returns:
+            A list containing the value of each sequence instance (see :meth:`apply`).
+
+        '''
+
+        return [instance.sequence_item.get_value(time) for instance in self.sequence_instances]
+
+    def apply(self, values, animation_object):
+        '''
+        Applies values evaluated by :meth:`evaluate` to an object.
+
+        :param values:
+            A list containing the value of each sequence instance.
+        :param animation_object:
+            The object to update with the animated values.
+        :returns:
+            The updated object.
+
+        '''
+
+        for instance, value in zip(self.sequence_instances, values):
             if instance.map_func is not None:
                 attribute_value = rgetattr(animation_object, instance.name)
                 value = instance.map_func(attribute_value, value)
@@ -126,13 +164,28 @@ class Animation:
         
         return animation_object
 
+    def is_constant(self, times):
+        '''
+        Determines whether the value of every sequence in this animation is the same at the specified times.
+
+        :param times:
+            A list of times relative to the start of the sequence, in seconds.
+
+        '''
+
+        for instance in self.sequence_instances:
+            values = [instance.sequence_item.get_value(time) for time in times]
+            if not all(values_equal(values[0], value) for value in values[1:]): return False
+
+        return True
+
 class FrameSnapshot:
     '''
     A snapshot of a single frame in the timeline.
 
     '''
     
-    def __init__(self, frame, objects):
+    def __init__(self, frame, objects, camera=None, object_map=None, changed_ids=None, subframes=None):
         '''
         Initializes an instance of :class:`FrameSnapshot`.
 
@@ -140,11 +193,154 @@ class FrameSnapshot:
             The frame that this snapshot was taken.
         :param objects:
             The objects in this frame.
+        :param camera:
+            The :class:`mathanim.objects.Camera` that this frame is viewed from.
+            Defaults to ``None``, meaning that the scene's camera is used.
+        :param object_map:
+            A dictionary mapping object ids to the objects in this frame, in draw order.
+            Defaults to ``None``.
+        :param changed_ids:
+            The ids of the objects that were added or animated in this frame (i.e. whose bounds
+            may have changed since the previous frame), in draw order. Defaults to ``None``, meaning that any
+            object may have changed.
+        :param subframes:
+            A dictionary mapping the ids of the objects (in this frame) that move during this
+            frame to their :class:`SubframeSamples`.
+            Defaults to ``None``, meaning that sub-frame times were not evaluated.
 
         '''
 
         self.frame = frame
         self.objects = objects
+        self.camera = camera
+        self.object_map = object_map
+        self.changed_ids = changed_ids
+        self.subframes = subframes
+
+class SubframeSamples:
+    '''
+    The states of an object that moves during a frame, at each sub-frame time.
+
+    :note:
+        The states are evaluated on demand into a single scratch copy of the object, so a moving
+        object is copied once per frame rather than once per sub-frame, and the caches that the
+        copy builds while it is drawn (e.g. gradient patterns) are reused between sub-frames.
+        The object returned for a sub-frame is only valid until the next one is requested.
+
+    '''
+
+    def __init__(self, scene_object, intervals, times):
+        '''
+        Initializes an instance of :class:`SubframeSamples`.
+
+        :param scene_object:
+            The object, evaluated at the frame time.
+        :param intervals:
+            The intervals of the timeline items animating the object in the frame.
+        :param times:
+            A list containing, for each interval, the time of its item at each sub-frame.
+
+        '''
+
+        self.scene_object = scene_object
+        self.intervals = intervals
+        self.times = times
+
+        self._scratch = None
+        self._names = [instance.name for interval in intervals for instance in interval.data.animation.sequence_instances]
+
+    def __len__(self):
+        return len(self.times[0])
+
+    def __getitem__(self, index):
+        '''
+        Gets the object at the sub-frame with the specified index.
+
+        '''
+
+        if self._scratch is None:
+            self._scratch = copy.deepcopy(self.scene_object)
+
+        # Start from the frame state so that sequences without a value at the sub-frame time
+        # (and relative mapping functions) behave as they would on a fresh copy of the object.
+        for name in self._names:
+            rsetattr(self._scratch, name, copy.copy(rgetattr(self.scene_object, name)))
+
+        for interval, item_times in zip(self.intervals, self.times):
+            interval.data.animation.animate(item_times[index], self._scratch)
+
+        return self._scratch
+
+class ValueCache:
+    '''
+    A bounded store of animated values, so that a render can reuse the values evaluated by an
+    earlier render at the same frame rate.
+
+    :note:
+        Only the values of sequence items that are expensive to evaluate are stored (see
+        :attr:`mathanim.sequences.SequenceItem.expensive`), and values are no longer stored once
+        they would exceed the size limit. A value is removed when it is taken, and values that
+        were never stored are simply evaluated again.
+
+    '''
+
+    def __init__(self, max_bytes=256 * 2**20):
+        '''
+        Initializes an instance of :class:`ValueCache`.
+
+        :param max_bytes:
+            The approximate number of bytes that the stored values may occupy. Defaults to 256 MiB.
+
+        '''
+
+        self.max_bytes = max_bytes
+        self.size = 0
+        self._values = {}
+
+    def __len__(self):
+        return len(self._values)
+
+    @staticmethod
+    def _size_of(value):
+        '''
+        Estimates the number of bytes occupied by a value.
+
+        '''
+
+        if isinstance(value, np.ndarray):
+            return value.nbytes
+
+        return sys.getsizeof(value)
+
+    def store(self, key, value):
+        '''
+        Stores a value if there is room for it.
+
+        '''
+
+        size = ValueCache._size_of(value)
+        if self.size + size > self.max_bytes: return
+
+        self._values[key] = value
+        self.size += size
+
+    def take(self, key):
+        '''
+        Removes and returns the value stored with the specified key.
+
+        :returns:
+            The value, or ``ValueCache.MISSING`` if no value is stored with the key.
+
+        '''
+
+        value = self._values.pop(key, ValueCache.MISSING)
+        if value is not ValueCache.MISSING:
+            self.size -= ValueCache._size_of(value)
+
+        return value
+
+# Returned by ValueCache.take when no value is stored (None is a valid sequence value).
+ValueCache.MISSING = object()
 
 class SceneSettings:
     '''
@@ -316,11 +512,15 @@ class Scene:
             Defaults to 1080p at 60 fps (HDTV).
         :param background_colour:
             The background colour of the scene. Defaults to black.
+            This can also be a :class:`mathanim.gradients.Gradient` given in the reference frame.
 
         '''
 
         self.settings = settings
-        self.background_colour = convert_colour(background_colour)
+        self.background_colour = background_colour
+
+        # The camera can be animated like any other object; by default, it shows the reference frame.
+        self.camera = Camera((settings.reference_width / 2, settings.reference_height / 2))
 
         self._items = []
         self._triggers = []
@@ -384,12 +584,22 @@ class Scene:
 
         self._triggers.append(*triggers)
 
-    def render(self, fps):
+    def render(self, fps, subframe_offsets=None, value_cache=None):
         '''
         Renders this scene.
         
         :parma fps:
             The frames per second that should be used in rendering.
+        :param subframe_offsets:
+            An optional list of offsets, in frames, of sub-frame times (e.g. ``[-0.25, 0, 0.25]``).
+            If specified, every object whose animation changes across the offsets is also
+            evaluated at each sub-frame time (see :attr:`FrameSnapshot.subframes`).
+            Defaults to ``None``.
+        :param value_cache:
+            An optional :class:`ValueCache`. Expensive values evaluated in each frame are stored in
+            it, and values that it already contains (e.g. from an earlier render at the same frame
+            rate) are taken out of it and reused instead of evaluating the sequences again.
+            Defaults to ``None``.
         :returns:
             Yields each frame in order as a :class:`FrameSnapshot`.
 
@@ -415,32 +625,312 @@ class Scene:
             triggers[frame].append(trigger)
         
         objects = {}
+        camera_id, camera = id(self.camera), self.camera
         for frame in range(total_frames):
+            # Triggers can modify objects in any way, so they invalidate every object. A dictionary
+            # (with no values) is used as an ordered set so that new objects are listed in draw order.
+            changed_ids = {}
+            animated = {}
             if frame in triggers:
                 for trigger in triggers[frame]:
                     trigger.call(objects)
 
+                changed_ids = None
+
             for interval in item_tree[frame]:
                 item = interval.data
                 if item.scene_object is None: continue
 
                 scene_object = None
                 object_id = id(item.scene_object)
-                if object_id not in objects:
+                if object_id == camera_id:
+                    # The camera is animated alongside the objects but it is not drawn.
+                    if camera is self.camera:
+                        camera = copy.deepcopy(self.camera)
+
+                    scene_object = camera
+                elif object_id not in objects:
                     scene_object = copy.deepcopy(item.scene_object)
                     objects[object_id] = scene_object
+                    if changed_ids is not None: changed_ids[object_id] = None
                 else:
                     scene_object = objects[object_id]
 
                 if item.animation is not None:
-                    # Calculate the time by finding the percent completion of the animation
-                    #
-                    # We subtract one in the denominator since interval.end is actually offset by a single frame.
-                    # This is due to the fact that the interval tree implementation excludes the upper bound.
-                    t = (frame - interval.begin) / (interval.end - interval.begin - 1)
-                    item.animation.animate(interval.data.duration * t, scene_object)
+                    if value_cache is None:
+                        item.animation.animate(Scene._item_time(interval, frame), scene_object)
+                    else:
+                        time = Scene._item_time(interval, frame)
+                        values = []
+                        for index, instance in enumerate(item.animation.sequence_instances):
+                            sequence_item = instance.sequence_item
+                            if not sequence_item.expensive:
+                                values.append(sequence_item.get_value(time))
+                                continue
+
+                            key = (frame, id(item), index)
+                            value = value_cache.take(key)
+                            if value is ValueCache.MISSING:
+                                value = sequence_item.get_value(time)
+                                value_cache.store(key, value)
+
+                            # Apply copies since animated values may be modified in place (e.g. ``position.x``).
+                            values.append(copy.copy(value))
+
+                        item.animation.apply(values, scene_object)
+                    if object_id == camera_id: continue
+
+                    if changed_ids is not None: changed_ids[object_id] = None
+                    animated.setdefault(object_id, []).append(interval)
+
+            subframes = None
+            if subframe_offsets is not None:
+                subframes = self._evaluate_subframes(objects, animated, frame, subframe_offsets)
+
+            yield FrameSnapshot(frame, iter(objects.values()), camera, objects, changed_ids, subframes)
+
+    @staticmethod
+    def _item_time(interval, frame):
+        '''
+        Gets the time, relative to the start of a timeline item, at the specified (possibly fractional) frame.
+
+        :param interval:
+            The interval of the item in the item tree.
+        :param frame:
+            The frame number.
+
+        '''
+
+        # Calculate the time by finding the percent completion of the animation
+        #
+        # We subtract one in the denominator since interval.end is actually offset by a single frame.
+        # This is due to the fact that the interval tree implementation excludes the upper bound.
+        span = interval.end - interval.begin - 1
+        t = (frame - interval.begin) / span if span > 0 else 1
+        return interval.data.duration * min(max(t, 0), 1)
+
+    @staticmethod
+    def _animate_at(interval, frame, scene_object, first_frame=None):
+        '''
+        Applies the animation of a timeline item to an object as if the timeline had been played up to
+        the specified frame, without evaluating any of the frames in between.
+
+        :note:
+            A sequence stops producing values once it is complete (e.g. a sequence that is shorter than
+            its animation), in which case playing the timeline leaves the value from the last frame at
+            which the sequence was defined. That frame is found directly from the sequence's duration.
+
+        :param interval:
+            The interval of the item in the item tree.
+        :param frame:
+            The frame number.
+        :param scene_object:
+            The object to update with the animated values.
+        :param first_frame:
+            The first frame at which the item was applied to the object (e.g. since the object was
+            removed and copied afresh). Defaults to ``None``, meaning the first frame of the item.
+
+        '''
+
+        item = interval.data
+        span = interval.end - interval.begin - 1
+        first_frame = interval.begin if first_frame is None else max(interval.begin, first_frame)
+
+        values = []
+        for instance in item.animation.sequence_instances:
+            instance_frame = frame
+            duration = instance.sequence_item.duration
+            if span > 0 and duration < item.animation.duration:
+                instance_frame = min(frame, interval.begin + math.floor(duration / item.duration * span))
 
-            yield FrameSnapshot(frame, iter(objects.values()))
+            value = None
+            if instance_frame >= first_frame:
+                value = instance.sequence_item.get_value(Scene._item_time(interval, instance_frame))
+
+            while value is None and instance_frame - 1 >= first_frame:
+                # Step back over frames whose time rounds past the end of the sequence.
+                instance_frame -= 1
+                value = instance.sequence_item.get_value(Scene._item_time(interval, instance_frame))
+
+            values.append(value)
+
+        item.animation.apply(values, scene_object)
+
+    def _evaluate_subframes(self, objects, animated, frame, offsets):
+        '''
+        Evaluates the animated objects of a frame at sub-frame times.
+
+        :param objects:
+            A dictionary mapping object ids to the objects in the frame (evaluated at the frame time).
+        :param animated:
+            A dictionary mapping the ids of the objects animated in the frame to the intervals
+            of the timeline items animating them.
+        :param frame:
+            The frame number.
+        :param offsets:
+            The offsets, in frames, of the sub-frame times.
+        :returns:
+            A dictionary mapping the ids of the frame objects that change across the sub-frame
+            times to their :class:`SubframeSamples`.
+
+        '''
+
+        subframes = {}
+        for object_id, intervals in animated.items():
+            scene_object = objects.get(object_id)
+            if scene_object is None or scene_object.stateful: continue
+
+            # Objects whose sequences have the same value at every sub-frame time did not move.
+            times = [[Scene._item_time(interval, frame + offset) for offset in offsets] for interval in intervals]
+            if all(interval.data.animation.is_constant(item_times) for interval, item_times in zip(intervals, times)):
+                continue
+
+            subframes[id(scene_object)] = SubframeSamples(scene_object, intervals, times)
+
+        return subframes
+
+    def snapshot_at(self, time, fps=60):
+        '''
+        Evaluates the state of the scene at a single point in time.
+
+        :note:
+            Unlike :meth:`render`, this does not play the timeline. Each object that has appeared by
+            the requested frame is copied and only its own timeline items are applied, at the times
+            they have reached in that frame. Removal triggers are taken into account, but other
+            triggers can modify objects arbitrarily and mapping functions (see
+            :class:`Animation.SequenceInstance`) may build on the value of the previous frame, so
+            if either is in effect by the requested frame, the timeline is played up to that frame instead.
+
+            Stateful objects (see :attr:`mathanim.objects.SceneObject.stateful`) are returned as
+            they are at the requested frame, without the state accumulated by drawing earlier frames.
+
+        :param time:
+            The time, in seconds. This is clamped to the duration of the scene.
+        :param fps:
+            The frames per second used to find the frame at the specified time. Defaults to 60.
+        :returns:
+            A :class:`FrameSnapshot`.
+
+        '''
+
+        return self._snapshots_at([time], fps)[0]
+
+    def _snapshots_at(self, times, fps=60):
+        '''
+        Evaluates the state of the scene at several points in time (see :meth:`snapshot_at`).
+
+        :note:
+            The timeline is played at most once, up to the latest of the frames that cannot be
+            evaluated directly, and the snapshots of all such frames are taken from that one pass.
+
+        :param times:
+            A list of times, in seconds.
+        :param fps:
+            The frames per second used to find the frame at each time. Defaults to 60.
+        :returns:
+            A list containing a :class:`FrameSnapshot` for each time, in order.
+
+        '''
+
+        last_frame = max(round(self.total_seconds * fps) - 1, 0)
+        frames = [min(max(round(time * fps), 0), last_frame) for time in times]
+
+        removals = []
+        replay_frame = None
+        for trigger in self._triggers:
+            trigger_frame = round(trigger.time * fps) + trigger.frame_delay
+            if isinstance(trigger, RemoveTrigger):
+                removals.append((trigger_frame, id(trigger._func_args[0])))
+            elif replay_frame is None or trigger_frame < replay_frame:
+                replay_frame = trigger_frame
+
+        for item in self._items:
+            if item.scene_object is None or item.animation is None: continue
+            if any(instance.map_func is not None for instance in item.animation.sequence_instances):
+                begin = round(item.start * fps)
+                if replay_frame is None or begin < replay_frame:
+                    replay_frame = begin
+
+        replay_frames = set() if replay_frame is None else {frame for frame in frames if frame >= replay_frame}
+        replayed = {}
+        if len(replay_frames) > 0:
+            for snapshot in self.render(fps):
+                if snapshot.frame not in replay_frames: continue
+                if snapshot.frame == max(replay_frames):
+                    # Nothing is rendered after the last frame, so its objects can be used as they are.
+                    replayed[snapshot.frame] = (snapshot.object_map, snapshot.camera)
+                    break
+
+                replayed[snapshot.frame] = copy.deepcopy((snapshot.object_map, snapshot.camera))
+
+        snapshots = []
+        for frame in frames:
+            if frame in replay_frames:
+                objects, camera = replayed.get(frame, ({}, self.camera))
+            else:
+                objects, camera = self._evaluate_frame(frame, fps, removals)
+
+            snapshots.append(FrameSnapshot(frame, iter(objects.values()), camera, objects))
+
+        return snapshots
+
+    def _evaluate_frame(self, frame, fps, removals):
+        '''
+        Evaluates the objects of a frame directly, without playing the timeline.
+
+        :param frame:
+            The frame number.
+        :param fps:
+            The frames per second of the timeline.
+        :param removals:
+            A list of ``(frame, object_id)`` tuples, one for each removal trigger.
+        :returns:
+            A tuple containing a dictionary mapping object ids to the objects in the frame
+            (in draw order) and the camera.
+
+        '''
+
+        # A removed object is copied afresh by the next item that is active after it was removed,
+        # so only the items active since its latest removal are applied to it.
+        removal_frames = {}
+        for removal_frame, object_id in removals:
+            if removal_frame <= frame:
+                removal_frames[object_id] = max(removal_frames.get(object_id, removal_frame), removal_frame)
+
+        total_seconds = self.total_seconds
+        intervals = []
+        for index, item in enumerate(self._items):
+            if item.scene_object is None: continue
+
+            begin, end = round(item.start * fps), round((item.end or total_seconds) * fps)
+            removal_frame = removal_frames.get(id(item.scene_object))
+            if begin >= end or begin > frame or (removal_frame is not None and end <= removal_frame): continue
+
+            # Items are applied in the order that the objects appeared (i.e. draw order).
+            appeared = begin if removal_frame is None else max(begin, removal_frame)
+            intervals.append((appeared, index, Interval(begin, end, item), removal_frame))
+
+        intervals.sort(key=lambda x: x[:2])
+
+        objects = {}
+        camera_id, camera = id(self.camera), self.camera
+        for _, _, interval, removal_frame in intervals:
+            item = interval.data
+            object_id = id(item.scene_object)
+            if object_id == camera_id:
+                if camera is self.camera:
+                    camera = copy.deepcopy(self.camera)
+
+                scene_object = camera
+            else:
+                scene_object = objects.get(object_id)
+                if scene_object is None:
+                    scene_object = objects[object_id] = copy.deepcopy(item.scene_object)
+
+            if item.animation is not None:
+                Scene._animate_at(interval, frame, scene_object, removal_frame)
+
+        return objects, camera
 
     @property
     def total_seconds(self):
@@ -476,7 +966,7 @@ class Scene:
 
         '''
 
-        self.__background_colour = convert_colour(value)
+        self.__background_colour = value if isinstance(value, gradients.Gradient) else convert_colour(value)
 
     def __enter__(self):
         print('scene entered')
@@ -491,11 +981,186 @@ class Scene:
 
         '''
 
-        render_context.set_source_rgb(*self.background_colour.rgb)
+        gradients.set_source(render_context, self.background_colour)
         render_context.paint()
 
+    def _create_index(self):
+        '''
+        Creates an empty spatial index over the bounds of scene objects.
+
+        '''
+
+        return GridIndex(max(self.settings.reference_width, self.settings.reference_height) / 16)
+
+    def _visible_objects(self, snapshot, view, index=None):
+        '''
+        Gets the objects of a frame whose bounds intersect the specified view, in draw order.
+
+        :param snapshot:
+            The :class:`FrameSnapshot` whose objects to cull.
+        :param view:
+            The :class:`mathanim.utils.Bounds` of the view.
+        :param index:
+            An optional :class:`mathanim.spatial.GridIndex` that persists between (consecutive)
+            frames. Only the objects that changed in the frame are updated in the index, and
+            the index is queried instead of testing every object. Defaults to ``None``.
+
+        '''
+
+        object_map = snapshot.object_map
+        if index is None or object_map is None:
+            return [x for x in snapshot.objects if x.bounds is None or x.bounds.intersects(view)]
+
+        changed_ids = object_map.keys() if snapshot.changed_ids is None else snapshot.changed_ids
+        for object_id in changed_ids:
+            if object_id in object_map:
+                index.update(object_id, object_map[object_id].bounds)
+
+        visible = []
+        for object_id in index.query(view):
+            if object_id in object_map:
+                visible.append(object_map[object_id])
+            else:
+                # The object was removed from the scene since it was indexed.
+                index.remove(object_id)
+
+        return visible
+
+    def _draw_frame(self, render_context, snapshot, index=None):
+        '''
+        Draws the objects of a frame, as seen by its camera, onto the specified :class:`cairo.Context`.
+
+        :note:
+            Objects whose bounds lie outside of the camera's view are skipped.
+
+        :param render_context:
+            A :class:`cairo.Context` whose user space is the scene's reference frame.
+        :param snapshot:
+            The :class:`FrameSnapshot` to draw.
+        :param index:
+            An optional :class:`mathanim.spatial.GridIndex` used to find the visible objects.
+            Defaults to ``None``.
+
+        '''
+
+        camera = snapshot.camera or self.camera
+        view = camera.view_bounds(self.settings.reference_width, self.settings.reference_height)
+        self._draw_objects(render_context, camera, self._visible_objects(snapshot, view, index))
+
+    def _draw_objects(self, render_context, camera, objects, clear=True):
+        '''
+        Clears the screen and draws objects, as seen by a camera, onto the specified :class:`cairo.Context`.
+
+        :param render_context:
+            A :class:`cairo.Context` whose user space is the scene's reference frame.
+        :param camera:
+            The :class:`mathanim.objects.Camera` that the objects are viewed from.
+        :param objects:
+            The objects to draw, in draw order.
+        :param clear:
+            Indicates whether the screen should be cleared first. Defaults to ``True``.
+
+        '''
+
+        if clear:
+            self._clear(render_context)
+
+        render_context.save()
+        render_context.transform(camera.get_matrix(self.settings.reference_width, self.settings.reference_height))
+        for frame_object in objects:
+            # Isolate transformations using save/restore.
+            render_context.save()
+            frame_object.draw(render_context)
+            render_context.restore()
+
+        render_context.restore()
+
+    def _draw_blurred_frame(self, render_context, snapshot, index=None):
+        '''
+        Draws a frame with motion blur onto the specified :class:`cairo.Context`.
+
+        :note:
+            Consecutive (in draw order) objects that move during the frame are drawn at each
+            sub-frame time onto a scratch surface covering only their bounds, and the sub-frame
+            images are averaged. Every other object is drawn once, at the frame time.
+
+        :param render_context:
+            A :class:`cairo.Context` whose user space is the scene's reference frame.
+        :param snapshot:
+            The :class:`FrameSnapshot` to draw. It must have been rendered with sub-frame offsets.
+        :param index:
+            An optional :class:`mathanim.spatial.GridIndex` used to find the visible objects.
+            Defaults to ``None``.
+
+        '''
+
+        width, height = self.settings.reference_width, self.settings.reference_height
+        camera = snapshot.camera or self.camera
+        objects = self._visible_objects(snapshot, camera.view_bounds(width, height), index)
+
+        self._clear(render_context)
+
+        subframes = snapshot.subframes or {}
+        base = render_context.get_matrix()
+        matrix = camera.get_matrix(width, height).multiply(base)
+        target = render_context.get_target()
+        frame_bounds = Bounds(0, 0, target.get_width(), target.get_height())
+
+        for moving, run in itertools.groupby(objects, key=lambda x: id(x) in subframes):
+            run = list(run)
+            if not moving:
+                self._draw_objects(render_context, camera, run, clear=False)
+                continue
+
+            run_samples = [subframes[id(x)] for x in run]
+            count = len(run_samples[0])
+
+            # The scratch surface only covers the bounds of the moving objects over the whole frame.
+            region = None
+            for i in range(count):
+                for sample_object in [samples[i] for samples in run_samples]:
+                    bounds = sample_object.bounds
+                    if bounds is None:
+                        region = frame_bounds
+                        break
+
+                    bounds = Bounds.from_points(geometry.to_device(bounds.corners, matrix)).expand(1)
+                    region = bounds if region is None else region.union(bounds)
+
+                if region is frame_bounds: break
+
+            if region is None or not region.intersects(frame_bounds): continue
+
+            x, y = max(int(region.x_min), 0), max(int(region.y_min), 0)
+            region_width = min(int(region.x_max) + 1, frame_bounds.x_max) - x
+            region_height = min(int(region.y_max) + 1, frame_bounds.y_max) - y
+            if region_width <= 0 or region_height <= 0: continue
+
+            surface = cairo.ImageSurface(cairo.FORMAT_ARGB32, region_width, region_height)
+            context = cairo.Context(surface)
+            context.translate(-x, -y)
+            context.transform(base)
+
+            accumulator = np.zeros((region_height, region_width, 4), dtype=np.uint16)
+            for i in range(count):
+                context.save()
+                context.set_operator(cairo.OPERATOR_CLEAR)
+                context.paint()
+                context.restore()
+
+                self._draw_objects(context, camera, [samples[i] for samples in run_samples], clear=False)
+                raster.accumulate(accumulator, raster.array_from_surface(surface))
+
+            pixels = raster.average(accumulator, count)
+            render_context.save()
+            render_context.identity_matrix()
+            render_context.set_source_surface(raster.surface_from_array(pixels), x, y)
+            render_context.paint()
+            render_context.restore()
+
     def export(self, filepath, output_width=None, output_height=None,
-               show_progress_bar=True, overwrite=True, codec='mp4v', fps=60):
+               show_progress_bar=True, overwrite=True, codec='mp4v', fps=60,
+               motion_blur_samples=1, shutter=0.5, supersample=1, high_precision=False, dither=True):
         '''
         Export the scene to a video file.
 
@@ -518,6 +1183,104 @@ class Scene:
             For a full list of video encoding codes, see https://www.fourcc.org/codecs.php.
         :param fps:
             The frames per second of the exported video.
+        :param motion_blur_samples:
+            The number of sub-frame times that moving objects are drawn at and averaged to
+            simulate motion blur (at most 256). Defaults to 1 (no motion blur).
+        :param shutter:
+            The fraction of a frame that the shutter is open for, centred on the frame time.
+            Only used with motion blur. Defaults to 0.5.
+        :param supersample:
+            The factor by which frames are supersampled for anti-aliasing (e.g. 2 or 4). Frames are
+            drawn at this multiple of the output resolution and downsampled with a box filter.
+            Defaults to 1 (no supersampling).
+        :param high_precision:
+            Indicates whether frames should be composited with more than 8 bits per channel (see
+            :func:`mathanim.raster.high_precision_format`) to avoid banding in slow gradients and
+            fades. Defaults to ``False``.
+        :param dither:
+            Indicates whether high precision frames should be dithered when they are converted to
+            8 bits per channel for encoding. Defaults to ``True``.
+
+        '''
+
+        if output_width is None:
+            output_width = self.settings.reference_width
+
+        if output_height is None:
+            output_height = self.settings.reference_height
+
+        filepath = self._prepare_filepath(filepath, overwrite)
+        video = cv2.VideoWriter(str(filepath), cv2.VideoWriter_fourcc(*codec), fps, (output_width, output_height))
+        for data in self._render_frames(output_width, output_height, fps, show_progress_bar, motion_blur_samples,
+                                        shutter, supersample, high_precision, dither):
+            video.write(data)
+
+        video.release()
+
+    def export_progressive(self, filepath, preview_filepath=None, output_width=None, output_height=None,
+                           preview_scale=0.25, preview_fps=None, show_progress_bar=True, overwrite=True,
+                           codec='mp4v', fps=60, motion_blur_samples=1, shutter=0.5, supersample=1,
+                           high_precision=False, dither=True, cache_bytes=256 * 2**20):
+        '''
+        Export the scene in two passes: a quick, low resolution preview followed by the full quality
+        video, which is rendered in the background.
+
+        :note:
+            The preview pass evaluates the timeline at the full frame rate (but only draws every few
+            frames) and keeps the values of expensive sequence items (e.g. procedures and data tracks)
+            in a :class:`ValueCache`, up to ``cache_bytes``. The full pass reuses these values instead
+            of evaluating the sequences again, releasing each one once it has been applied, and
+            evaluates every other value itself. Stateful objects (e.g. trails) are drawn on every
+            frame of the preview pass, so they evolve exactly as they do in the full pass.
+
+            The full pass renders a copy of the timeline, so animations and triggers added to the scene
+            after this method returns do not affect it. The objects and camera are shared, however, and
+            must not be modified until the full quality video has been written.
+
+        :param filepath:
+            The path where the full quality video should be saved.
+        :param preview_filepath:
+            The path where the preview video should be saved. Defaults to the full quality path
+            with a ``_preview`` suffix (e.g. ``scene_preview.mp4``).
+        :param output_width:
+            The horizontal resolution of the full quality video, in pixels.
+            Defaults to the width of the reference frame.
+        :param output_height:
+            The vertical resolution of the full quality video, in pixels.
+            Defaults to the height of the reference frame.
+        :param preview_scale:
+            The resolution of the preview relative to the full quality video. Defaults to 0.25.
+        :param preview_fps:
+            The frames per second of the preview. This is rounded so that it divides the frames per
+            second of the full quality video. Defaults to a quarter of the frames per second.
+        :param show_progress_bar:
+            Indicates whether progress bars should be displayed while the videos are rendered.
+            Defaults to ``True``.
+        :param overwrite:
+            Indicates whether the export files should be overwritten in the case that they exist.
+            Defaults to ``True``.
+        :param codec:
+            The FourCC indicating the codec of both videos. Defaults to mp4v encoding.
+        :param fps:
+            The frames per second of the full quality video.
+        :param motion_blur_samples:
+            The number of sub-frame times used for motion blur in the full quality video (see :meth:`export`).
+            Defaults to 1.
+        :param shutter:
+            The fraction of a frame that the shutter is open for (see :meth:`export`). Defaults to 0.5.
+        :param supersample:
+            The factor by which full quality frames are supersampled (see :meth:`export`). Defaults to 1.
+        :param high_precision:
+            Indicates whether full quality frames should be composited with more than 8 bits per channel
+            (see :meth:`export`). Defaults to ``False``.
+        :param dither:
+            Indicates whether high precision frames should be dithered. Defaults to ``True``.
+        :param cache_bytes:
+            The approximate number of bytes of animated values that the preview pass may keep for
+            the full pass. Defaults to 256 MiB.
+        :returns:
+            A :class:`concurrent.futures.Future` that completes when the full quality video has been
+            written. The preview has already been written when this method returns.
 
         '''
 
@@ -527,11 +1290,503 @@ class Scene:
         if output_height is None:
             output_height = self.settings.reference_height
 
-        surface = cairo.ImageSurface(cairo.FORMAT_ARGB32, output_width, output_height)
+        filepath = Path(filepath)
+        if preview_filepath is None:
+            preview_filepath = filepath.with_name('{}_preview{}'.format(filepath.stem, filepath.suffix))
+
+        filepath = self._prepare_filepath(filepath, overwrite)
+        preview_filepath = self._prepare_filepath(preview_filepath, overwrite)
+
+        frame_step = max(round(fps / (preview_fps or fps / 4)), 1)
+        preview_width, preview_height = max(round(output_width * preview_scale), 1), max(round(output_height * preview_scale), 1)
+
+        value_cache = ValueCache(cache_bytes)
+        video = cv2.VideoWriter(str(preview_filepath), cv2.VideoWriter_fourcc(*codec), fps / frame_step, (preview_width, preview_height))
+        for data in self._render_frames(preview_width, preview_height, fps, show_progress_bar,
+                                        value_cache=value_cache, frame_step=frame_step):
+            video.write(data)
+
+        video.release()
+
+        # The full pass only takes values out of the cache (its misses are not worth storing).
+        value_cache.max_bytes = 0
+
+        scene = copy.copy(self)
+        scene._items, scene._triggers = list(self._items), list(self._triggers)
+
+        def render_full():
+            video = cv2.VideoWriter(str(filepath), cv2.VideoWriter_fourcc(*codec), fps, (output_width, output_height))
+            for data in scene._render_frames(output_width, output_height, fps, show_progress_bar, motion_blur_samples,
+                                            shutter, supersample, high_precision, dither, value_cache):
+                video.write(data)
+
+            video.release()
+
+        executor = ThreadPoolExecutor(1)
+        future = executor.submit(render_full)
+        executor.shutdown(wait=False)
+        return future
+
+    def export_hls(self, directory, segment_duration=2, output_width=None, output_height=None,
+                   show_progress_bar=True, overwrite=True, fps=60, codec='libx264', ffmpeg='ffmpeg',
+                   motion_blur_samples=1, shutter=0.5, supersample=1, high_precision=False, dither=True):
+        '''
+        Export the scene as an HLS stream: a playlist (``index.m3u8``) and a series of video segments.
+
+        :note:
+            The frames are piped to ffmpeg as they are rendered. Each segment is written (and added to
+            the playlist) as soon as it has been encoded, so the stream can be played back (e.g. by
+            opening the playlist in a local player) while the rest of the scene is still rendering.
+
+        :param directory:
+            The directory where the playlist and segments should be saved.
+        :param segment_duration:
+            The duration of a segment, in seconds. Playback can start once the first segment
+            has been written. Defaults to 2.
+        :param output_width:
+            The horizontal resolution of the video, in pixels (this must be even).
+            Defaults to the width of the reference frame.
+        :param output_height:
+            The vertical resolution of the video, in pixels (this must be even).
+            Defaults to the height of the reference frame.
+        :param show_progress_bar:
+            Indicates whether a progress bar should be displayed while the video is rendered.
+            Defaults to ``True``.
+        :param overwrite:
+            Indicates whether an existing stream in the directory should be overwritten.
+            Defaults to ``True``.
+        :param fps:
+            The frames per second of the exported video.
+        :param codec:
+            The name of the ffmpeg encoder used to encode the segments. Defaults to libx264 (H.264).
+        :param ffmpeg:
+            The path to (or name of) the ffmpeg executable. Defaults to ``ffmpeg``.
+        :param motion_blur_samples:
+            The number of sub-frame times used for motion blur (see :meth:`export`). Defaults to 1.
+        :param shutter:
+            The fraction of a frame that the shutter is open for (see :meth:`export`). Defaults to 0.5.
+        :param supersample:
+            The factor by which frames are supersampled (see :meth:`export`). Defaults to 1.
+        :param high_precision:
+            Indicates whether frames should be composited with more than 8 bits per channel
+            (see :meth:`export`). Defaults to ``False``.
+        :param dither:
+            Indicates whether high precision frames should be dithered. Defaults to ``True``.
+
+        '''
+
+        executable = shutil.which(ffmpeg)
+        if executable is None:
+            raise PathError('Tried to export HLS stream but the ffmpeg executable \'{}\' could not be found. '.format(ffmpeg) +
+                            'Install ffmpeg or specify the path to it using the ffmpeg argument.')
+
+        if output_width is None:
+            output_width = self.settings.reference_width
+
+        if output_height is None:
+            output_height = self.settings.reference_height
+
+        # The segments are encoded with 4:2:0 chroma subsampling, which requires even dimensions.
+        if output_width % 2 != 0 or output_height % 2 != 0:
+            raise ArgumentError('The resolution of an HLS stream must be even but found {}x{}.'.format(output_width, output_height))
+
+        directory = Path(directory)
+        if directory.exists() and not directory.is_dir():
+            raise PathError('Tried to export HLS stream but \'{}\' is not a valid directory.'.format(directory))
+
+        segments = list(directory.glob('segment_*.ts'))
+        if len(segments) > 0 and not overwrite:
+            raise IOError('The directory \'{}\' already contains HLS segments and overwrite is disabled!'.format(directory))
+
+        playlist = self._prepare_filepath(directory / 'index.m3u8', overwrite)
+        for segment in segments:
+            segment.unlink()
+
+        # Keyframes are forced at segment boundaries so that every segment has the same duration.
+        # The event playlist type makes ffmpeg rewrite the playlist after every segment.
+        command = [executable, '-loglevel', 'error', '-y',
+                   '-f', 'rawvideo', '-pix_fmt', 'bgr24', '-s', '{}x{}'.format(output_width, output_height),
+                   '-r', str(fps), '-i', '-',
+                   '-c:v', codec, '-pix_fmt', 'yuv420p',
+                   '-force_key_frames', 'expr:gte(t,n_forced*{})'.format(segment_duration),
+                   '-f', 'hls', '-hls_time', str(segment_duration), '-hls_list_size', '0',
+                   '-hls_playlist_type', 'event', '-hls_segment_filename', str(directory / 'segment_%05d.ts'),
+                   str(playlist)]
+
+        # The error output is written to a temporary file rather than a pipe, since a pipe that
+        # is only read once encoding is done could fill up and block ffmpeg (and the renderer).
+        with tempfile.TemporaryFile() as error_file:
+            process = subprocess.Popen(command, stdin=subprocess.PIPE, stderr=error_file)
+            try:
+                for data in self._render_frames(output_width, output_height, fps, show_progress_bar, motion_blur_samples,
+                                                shutter, supersample, high_precision, dither):
+                    process.stdin.write(data.tobytes())
+            except BrokenPipeError:
+                # ffmpeg exited early; its error message is reported below.
+                pass
+            finally:
+                process.stdin.close()
+                process.wait()
+
+            error_file.seek(0)
+            errors = error_file.read()
+
+        if process.returncode != 0:
+            raise IOError('ffmpeg failed to encode the HLS stream: {}'.format(errors.decode(errors='replace').strip()))
+
+    def _render_frames(self, output_width, output_height, fps, show_progress_bar=True, motion_blur_samples=1,
+                       shutter=0.5, supersample=1, high_precision=False, dither=True, value_cache=None, frame_step=1):
+        '''
+        Renders the frames of the scene for encoding.
+
+        :note:
+            The parameters are described in :meth:`export`, except for ``value_cache`` (see
+            :meth:`render`) and ``frame_step``, the number of frames per rendered frame (the
+            timeline is still evaluated at every frame, so only every ``frame_step``-th frame is drawn).
+            Stateful objects are drawn on every frame since drawing them updates their state.
+
+        :returns:
+            Yields each frame in order as a numpy array of BGR bytes with shape
+            ``(output_height, output_width, 3)``. The array is only valid until the next frame is rendered.
+
+        '''
+
+        supersample = max(int(supersample), 1)
+        surface_format = raster.high_precision_format() if high_precision else cairo.FORMAT_ARGB32
+        surface = cairo.ImageSurface(surface_format, output_width * supersample, output_height * supersample)
         context = cairo.Context(surface)
 
         # Normalize coordinate system to the reference frame
-        context.scale(output_width / self.settings.reference_width, output_height / self.settings.reference_height)
+        context.scale(output_width * supersample / self.settings.reference_width,
+                      output_height * supersample / self.settings.reference_height)
+
+        output_shape = (output_width, output_height)
+        offsets = None
+        if motion_blur_samples > 1:
+            motion_blur_samples = min(motion_blur_samples, 256)
+            offsets = list(np.linspace(-shutter / 2, shutter / 2, motion_blur_samples))
+
+        index = self._create_index()
+        if high_precision:
+            float_buffer = np.empty((output_height * supersample, output_width * supersample, 4), dtype=np.float32)
+            frame_buffer = np.empty((output_height, output_width, 4), dtype=np.float32)
+            quantizer = raster.Quantizer(output_width, output_height, dither)
+        elif supersample > 1:
+            frame_buffer = np.empty((output_height, output_width, 4), dtype=np.uint8)
+        for snapshot in tqdm.tqdm(self.render(fps, offsets, value_cache), disable=not show_progress_bar):
+            if snapshot.frame % frame_step != 0:
+                # Draw the stateful objects into the frame (which is cleared before the next
+                # frame is drawn), which also keeps the index in step with the skipped frame.
+                camera = snapshot.camera or self.camera
+                view = camera.view_bounds(self.settings.reference_width, self.settings.reference_height)
+                stateful = [x for x in self._visible_objects(snapshot, view, index) if x.stateful]
+                if len(stateful) > 0:
+                    self._draw_objects(context, camera, stateful, clear=False)
+
+                continue
+
+            if offsets is None:
+                self._draw_frame(context, snapshot, index)
+            else:
+                self._draw_blurred_frame(context, snapshot, index)
+
+            # Convert image surface buffer to numpy array and drop alpha values from frame data
+            if high_precision:
+                data = raster.float_from_surface(surface, float_buffer)
+                if supersample > 1:
+                    data = raster.downsample(data, supersample, frame_buffer)
+
+                data = quantizer(data)
+            elif supersample > 1:
+                data = raster.downsample(raster.array_from_surface(surface), supersample, frame_buffer)[:,:,:3]
+            else:
+                data = np.ndarray(shape=(*reversed(output_shape), 4), dtype=np.uint8, buffer=surface.get_data())[:,:,:3]
+
+            yield data
+
+    def export_image(self, filepath, time=0, output_width=None, output_height=None, tile_size=512,
+                     threads=None, overwrite=True, fps=60):
+        '''
+        Export a single frame of the scene to an image file.
+
+        :note:
+            The frame is split into tiles that are rasterized in parallel threads (cairo does not
+            hold the global interpreter lock while it draws). Each tile only draws the objects whose
+            bounds overlap it. If the frame contains a stateful object (see
+            :attr:`mathanim.objects.SceneObject.stateful`), the frame is drawn as a single tile.
+
+        :param filepath:
+            The path where the rendered image should be saved. The image format is determined by
+            the file extension (e.g. ``.png``).
+        :param time:
+            The time, in seconds, of the frame to export. Defaults to 0.
+        :param output_width:
+            The horizontal resolution of the image, in pixels.
+            Defaults to the width of the reference frame.
+        :param output_height:
+            The vertical resolution of the image, in pixels.
+            Defaults to the height of the reference frame.
+        :param tile_size:
+            The width and height of a tile, in pixels. Defaults to 512.
+        :param threads:
+            The number of threads used to rasterize tiles. Defaults to the number of processors.
+        :param overwrite:
+            Indicates whether the export file should be overwritten in the case that it exists.
+            Defaults to ``True``.
+        :param fps:
+            The frames per second used to find the frame at the specified time. Defaults to 60.
+
+        '''
+
+        if output_width is None:
+            output_width = self.settings.reference_width
+
+        if output_height is None:
+            output_height = self.settings.reference_height
+
+        filepath = self._prepare_filepath(filepath, overwrite)
+
+        image = self._render_tiled(self.snapshot_at(time, fps), output_width, output_height, tile_size, threads)
+        cv2.imwrite(str(filepath), np.ascontiguousarray(image[:, :, :3]))
+
+    def export_thumbnails(self, directory, times, width=320, height=None, threads=None, overwrite=True, fps=60,
+                          name_format='thumbnail_{:04d}.png'):
+        '''
+        Export thumbnails of the scene at arbitrary times.
+
+        :note:
+            Each thumbnail is evaluated directly at its time (see :meth:`snapshot_at`) rather than by
+            playing the timeline (which is played at most once, if at all), and the thumbnails are
+            rasterized in parallel threads.
+
+        :param directory:
+            The directory where the thumbnails should be saved.
+        :param times:
+            A list of times, in seconds.
+        :param width:
+            The width of a thumbnail, in pixels. Defaults to 320.
+        :param height:
+            The height of a thumbnail, in pixels. Defaults to the height that preserves the
+            aspect ratio of the reference frame.
+        :param threads:
+            The number of threads used to render thumbnails. Defaults to the number of processors.
+        :param overwrite:
+            Indicates whether existing thumbnails should be overwritten. Defaults to ``True``.
+        :param fps:
+            The frames per second used to find the frame at each time. Defaults to 60.
+        :param name_format:
+            The format of the filename of a thumbnail, which is given the index of its time. The image
+            format is determined by the file extension. Defaults to ``thumbnail_{:04d}.png``.
+        :returns:
+            A list containing the path of each thumbnail.
+
+        '''
+
+        directory = Path(directory)
+        if directory.exists() and not directory.is_dir():
+            raise PathError('Tried to export thumbnails but \'{}\' is not a valid directory.'.format(directory))
+
+        filepaths = [self._prepare_filepath(directory / name_format.format(i), overwrite) for i in range(len(times))]
+        width, height = self._thumbnail_size(width, height)
+        for filepath, image in zip(filepaths, self._render_thumbnails(times, width, height, threads, fps)):
+            cv2.imwrite(str(filepath), np.ascontiguousarray(image[:, :, :3]))
+
+        return filepaths
+
+    def export_contact_sheet(self, filepath, times=None, count=48, columns=8, width=320, height=None,
+                             spacing=8, threads=None, overwrite=True, fps=60):
+        '''
+        Export a contact sheet (storyboard): a grid of thumbnails of the scene.
+
+        :note:
+            Each thumbnail is evaluated directly at its time (see :meth:`snapshot_at`) rather than by
+            playing the timeline (which is played at most once, if at all), and the thumbnails are
+            rasterized in parallel threads.
+
+        :param filepath:
+            The path where the contact sheet should be saved. The image format is determined by
+            the file extension (e.g. ``.png``).
+        :param times:
+            A list of times, in seconds, of the thumbnails, in reading order.
+            Defaults to ``count`` times evenly spaced over the duration of the scene.
+        :param count:
+            The number of thumbnails when no times are specified. Defaults to 48.
+        :param columns:
+            The number of thumbnails in each row. Defaults to 8.
+        :param width:
+            The width of a thumbnail, in pixels. Defaults to 320.
+        :param height:
+            The height of a thumbnail, in pixels. Defaults to the height that preserves the
+            aspect ratio of the reference frame.
+        :param spacing:
+            The gap between (and around) the thumbnails, in pixels. Defaults to 8.
+        :param threads:
+            The number of threads used to render thumbnails. Defaults to the number of processors.
+        :param overwrite:
+            Indicates whether the export file should be overwritten in the case that it exists.
+            Defaults to ``True``.
+        :param fps:
+            The frames per second used to find the frame at each time. Defaults to 60.
+
+        '''
+
+        if times is None:
+            # Sample the middle of each of the equal parts of the scene.
+            times = [(i + 0.5) * self.total_seconds / count for i in range(count)]
+
+        if len(times) == 0:
+            raise ArgumentError('A contact sheet requires at least one thumbnail.')
+
+        filepath = self._prepare_filepath(filepath, overwrite)
+        width, height = self._thumbnail_size(width, height)
+        columns = max(min(columns, len(times)), 1)
+        rows = -(-len(times) // columns)
+
+        sheet = np.zeros((rows * (height + spacing) + spacing, columns * (width + spacing) + spacing, 3), dtype=np.uint8)
+        for i, image in enumerate(self._render_thumbnails(times, width, height, threads, fps)):
+            y, x = spacing + (i // columns) * (height + spacing), spacing + (i % columns) * (width + spacing)
+            sheet[y:y + height, x:x + width] = image[:, :, :3]
+
+        cv2.imwrite(str(filepath), sheet)
+
+    def _thumbnail_size(self, width, height):
+        '''
+        Gets the size of a thumbnail, filling in a missing height using the aspect ratio of the reference frame.
+
+        '''
+
+        if height is None:
+            height = max(round(width * self.settings.reference_height / self.settings.reference_width), 1)
+
+        return width, height
+
+    def _render_thumbnails(self, times, width, height, threads=None, fps=60):
+        '''
+        Evaluates the scene at arbitrary times and rasterizes the frames in parallel threads.
+
+        :returns:
+            Yields a numpy array of premultiplied BGRA bytes with shape ``(height, width, 4)`` for each time, in order.
+
+        '''
+
+        def render_thumbnail(snapshot):
+            # Each thumbnail is drawn as a single tile since the thumbnails are already rendered in parallel.
+            return self._render_tiled(snapshot, width, height, max(width, height))
+
+        # The snapshots are evaluated up front so that the timeline is played at most once (and never
+        # from several threads); only the rasterization runs in parallel.
+        snapshots = self._snapshots_at(times, fps)
+        with ThreadPoolExecutor(threads or os.cpu_count()) as executor:
+            yield from executor.map(render_thumbnail, snapshots)
+
+    def export_lottie(self, filepath, fps=60, sample_rate=None, overwrite=True):
+        '''
+        Export this scene as a Lottie (JSON) vector animation, without rasterizing any frames.
+
+        :note:
+            Linear ramps are converted to keyframes directly and other sequence items are baked at
+            the sample rate. Only some objects can be converted (see :func:`mathanim.lottie.convert`).
+
+        :param filepath:
+            The path where the animation should be saved (typically with a ``.json`` extension).
+        :param fps:
+            The frames per second of the animation. Defaults to 60.
+        :param sample_rate:
+            The number of keyframes per second used to bake sequence items that are not linear.
+            Defaults to the frames per second.
+        :param overwrite:
+            Indicates whether the export file should be overwritten in the case that it exists.
+            Defaults to ``True``.
+
+        '''
+
+        from mathanim import lottie
+
+        animation = lottie.convert(self, fps, sample_rate)
+        filepath = self._prepare_filepath(filepath, overwrite)
+        with open(filepath, 'w') as file:
+            json.dump(animation, file, separators=(',', ':'))
+
+    def _render_tiled(self, snapshot, output_width, output_height, tile_size=512, threads=None):
+        '''
+        Rasterizes a frame in parallel tiles.
+
+        :param snapshot:
+            The :class:`FrameSnapshot` to rasterize.
+        :param output_width:
+            The width of the output, in pixels.
+        :param output_height:
+            The height of the output, in pixels.
+        :param tile_size:
+            The width and height of a tile, in pixels. Defaults to 512.
+        :param threads:
+            The number of threads used to rasterize tiles. Defaults to the number of processors.
+        :returns:
+            A numpy array of premultiplied BGRA bytes with shape ``(output_height, output_width, 4)``.
+
+        '''
+
+        reference_width, reference_height = self.settings.reference_width, self.settings.reference_height
+        camera = snapshot.camera or self.camera
+        objects = self._visible_objects(snapshot, camera.view_bounds(reference_width, reference_height))
+
+        if any(x.stateful for x in objects):
+            tile_size = max(output_width, output_height)
+
+        # Assign objects to tiles using a spatial index over their bounds in output pixels.
+        base = cairo.Matrix(output_width / reference_width, 0, 0, output_height / reference_height, 0, 0)
+        matrix = camera.get_matrix(reference_width, reference_height).multiply(base)
+        index = GridIndex(tile_size)
+        for i, frame_object in enumerate(objects):
+            bounds = frame_object.bounds
+            if bounds is not None:
+                # Expand by a pixel to include anti-aliased edges.
+                bounds = Bounds.from_points(geometry.to_device(bounds.corners, matrix)).expand(1)
+
+            index.insert(i, bounds)
+
+        tiles = [(x, y, min(tile_size, output_width - x), min(tile_size, output_height - y))
+                 for y in range(0, output_height, tile_size) for x in range(0, output_width, tile_size)]
+
+        # Build the caches that depend on the whole frame once, before the tiles share the objects.
+        if len(tiles) > 1:
+            for frame_object in objects:
+                frame_object.prepare(matrix, output_width, output_height)
+
+        image = np.empty((output_height, output_width, 4), dtype=np.uint8)
+
+        def render_tile(tile):
+            x, y, width, height = tile
+            surface = cairo.ImageSurface(cairo.FORMAT_ARGB32, width, height)
+            context = cairo.Context(surface)
+            context.translate(-x, -y)
+            context.scale(base.xx, base.yy)
+
+            tile_objects = [objects[i] for i in index.query(Bounds(x, y, x + width, y + height))]
+            self._draw_objects(context, camera, tile_objects)
+            image[y:y + height, x:x + width] = raster.array_from_surface(surface)
+
+        if len(tiles) == 1:
+            render_tile(tiles[0])
+        else:
+            with ThreadPoolExecutor(threads or os.cpu_count()) as executor:
+                # Consume the results so that exceptions raised in a tile are propagated.
+                list(executor.map(render_tile, tiles))
+
+        return image
+
+    def _prepare_filepath(self, filepath, overwrite):
+        '''
+        Validates an export path, removing the existing file if overwriting is enabled.
+
+        :param filepath:
+            The path where the exported result should be saved.
+        :param overwrite:
+            Indicates whether the file should be overwritten in the case that it exists.
+        :returns:
+            The path as a :class:`pathlib.Path` object.
+
+        '''
 
         filepath = Path(filepath)
         if filepath.exists():
@@ -542,21 +1797,6 @@ class Scene:
                 raise IOError('The file \'{}\' already exists and overwrite is disabled!'.format(filepath))
 
             filepath.unlink()
-            
-        filepath.parent.mkdir(parents=True, exist_ok=True)
 
-        output_shape = (output_width, output_height)
-        video = cv2.VideoWriter(str(filepath), cv2.VideoWriter_fourcc(*codec), fps, output_shape)
-        for snapshot in tqdm.tqdm(self.render(fps), disable=not show_progress_bar):
-            self._clear(context)
-            for frame_object in snapshot.objects:
-                # Isolate transformations using save/restore.
-                context.save()
-                frame_object.draw(context)
-                context.restore()
-    
-            # Convert image surface buffer to numpy array and drop alpha values from frame data
-            data = np.ndarray(shape=(*reversed(output_shape), 4), dtype=np.uint8, buffer=surface.get_data())[:,:,:3]
-            video.write(data)
-
-        video.release()
\ No newline at end of file
+        filepath.parent.mkdir(parents=True, exist_ok=True)
+        return filepath
@@ -0,0 +1,238 @@
+import re
+import csv
+import json
+import numpy as np
+from pathlib import Path
+from mathanim.errors import PathError, ArgumentError
+
+class ColumnarData:
+    '''
+    A collection of named data columns backed by memory-mapped files.
+
+    :note:
+        Columns are numpy arrays whose first axis indexes rows. A column may have more than one
+        dimension (e.g. a column with shape ``(rows, entities)`` holding one value per entity per row).
+        Since the columns are memory-mapped, only the pages containing the rows that are actually
+        read are loaded from disk.
+
+    '''
+
+    def __init__(self, columns):
+        '''
+        Initializes an instance of :class:`ColumnarData`.
+
+        :param columns:
+            A dictionary mapping column names to array-like objects with the same number of rows.
+
+        '''
+
+        self.columns = dict(columns)
+
+        row_counts = {len(column) for column in self.columns.values()}
+        if len(row_counts) > 1:
+            raise ArgumentError('Columns of ColumnarData must have the same number of rows.')
+
+    @classmethod
+    def from_npy(cls, paths):
+        '''
+        Memory-maps columns stored as ``.npy`` files.
+
+        :param paths:
+            A path to a single ``.npy`` file (whose column is named after the file) or a
+            dictionary mapping column names to paths.
+
+        '''
+
+        if not isinstance(paths, dict):
+            paths = {Path(paths).stem: paths}
+
+        columns = {}
+        for name, path in paths.items():
+            path = Path(path)
+            if not path.is_file():
+                raise PathError('Tried to load column \'{}\' but \'{}\' is not a valid filepath.'.format(name, path))
+
+            columns[name] = np.load(path, mmap_mode='r')
+
+        return cls(columns)
+
+    @classmethod
+    def from_directory(cls, directory):
+        '''
+        Memory-maps every ``.npy`` file in a directory as a column named after the file.
+
+        :param directory:
+            The directory containing the column files.
+
+        '''
+
+        directory = Path(directory)
+        if not directory.is_dir():
+            raise PathError('Tried to load columns but \'{}\' is not a valid directory.'.format(directory))
+
+        return cls.from_npy({path.stem: path for path in sorted(directory.glob('*.npy'))})
+
+    @classmethod
+    def from_csv(cls, filepath, cache_directory=None, delimiter=',', chunk_size=65536):
+        '''
+        Loads the numeric columns of a CSV file (with a header row).
+
+        :note:
+            CSV files cannot be memory-mapped directly, so the file is converted, in chunks, to a
+            directory of ``.npy`` column files the first time it is loaded. Later loads memory-map
+            the converted columns (as long as they are newer than the CSV file). Converting replaces
+            every column file in the cache directory. Blank lines are skipped.
+
+        :param filepath:
+            The path to the CSV file.
+        :param cache_directory:
+            The directory to store the converted columns in. Defaults to a directory next
+            to the CSV file with the same name and a ``.columns`` suffix.
+        :param delimiter:
+            The delimiter of the CSV file. Defaults to a comma.
+        :param chunk_size:
+            The number of rows converted at a time. Defaults to 65536.
+
+        '''
+
+        filepath = Path(filepath)
+        if not filepath.is_file():
+            raise PathError('Tried to load CSV data but \'{}\' is not a valid filepath.'.format(filepath))
+
+        cache_directory = Path(cache_directory) if cache_directory is not None else filepath.with_suffix('.columns')
+
+        # The marker maps the column names to their files and is only written once the conversion is complete.
+        marker = cache_directory / '.complete'
+        if marker.is_file() and marker.stat().st_mtime >= filepath.stat().st_mtime:
+            try:
+                with open(marker) as file:
+                    filenames = json.load(file)
+            except ValueError:
+                # The marker was written by an older version without the filenames, so convert again.
+                filenames = None
+
+            if isinstance(filenames, dict):
+                return cls.from_npy({name: cache_directory / filename for name, filename in filenames.items()})
+
+        # Remove the columns of an earlier conversion, whose header may have been different.
+        cache_directory.mkdir(parents=True, exist_ok=True)
+        if marker.exists():
+            marker.unlink()
+
+        for path in cache_directory.glob('*.npy'):
+            path.unlink()
+
+        with open(filepath, newline='') as file:
+            reader = csv.reader(file, delimiter=delimiter)
+            names = next(reader, [])
+            row_count = sum(1 for row in reader if row)
+
+        filenames = _column_filenames(names)
+        columns = [np.lib.format.open_memmap(cache_directory / filenames[name], mode='w+',
+                                             dtype=np.float64, shape=(row_count,)) for name in names]
+
+        with open(filepath, newline='') as file:
+            reader = csv.reader(file, delimiter=delimiter)
+            next(reader)
+
+            start, chunk = 0, []
+            for row_number, row in enumerate(reader, start=2):
+                if not row: continue
+                if len(row) != len(names):
+                    raise ArgumentError('Expected {} values but found {} on line {} of \'{}\'.'.format(
+                        len(names), len(row), row_number, filepath))
+
+                try:
+                    chunk.append([float(value) if value else np.nan for value in row])
+                except ValueError:
+                    raise ArgumentError('Non-numeric value on line {} of \'{}\'.'.format(row_number, filepath))
+
+                if len(chunk) == chunk_size:
+                    _write_chunk(columns, start, chunk)
+                    start, chunk = start + len(chunk), []
+
+            _write_chunk(columns, start, chunk)
+
+        for column in columns:
+            column.flush()
+
+        with open(marker, 'w') as file:
+            json.dump(filenames, file)
+
+        return cls.from_npy({name: cache_directory / filename for name, filename in filenames.items()})
+
+    @classmethod
+    def from_parquet(cls, filepath, columns=None):
+        '''
+        Memory-maps the columns of a Parquet file.
+
+        :note:
+            This requires the ``pyarrow`` package. Columns that cannot be viewed without copying
+            (e.g. compressed columns or columns with missing values) are materialized.
+
+        :param filepath:
+            The path to the Parquet file.
+        :param columns:
+            The names of the columns to load. Defaults to every column.
+
+        '''
+
+        import pyarrow.parquet as parquet
+
+        filepath = Path(filepath)
+        if not filepath.is_file():
+            raise PathError('Tried to load Parquet data but \'{}\' is not a valid filepath.'.format(filepath))
+
+        table = parquet.read_table(filepath, columns=columns, memory_map=True)
+        return cls({name: table.column(name).to_numpy() for name in table.column_names})
+
+    def __getitem__(self, name):
+        '''
+        Gets the column with the specified name.
+
+        '''
+
+        return self.columns[name]
+
+    def __contains__(self, name):
+        return name in self.columns
+
+    def __len__(self):
+        '''
+        Gets the number of rows.
+
+        '''
+
+        return len(next(iter(self.columns.values()))) if self.columns else 0
+
+def _column_filenames(names):
+    '''
+    Maps the column names of a CSV header to unique, filesystem-safe ``.npy`` filenames.
+
+    '''
+
+    if len(set(names)) != len(names):
+        raise ArgumentError('The header of a CSV file must not contain duplicate column names.')
+
+    filenames, used = {}, set()
+    for index, name in enumerate(names):
+        filename = re.sub(r'[^\w.-]', '_', name).strip('.') or 'column'
+        if filename.lower() in used:
+            filename = '{}_{}'.format(filename, index)
+
+        used.add(filename.lower())
+        filenames[name] = filename + '.npy'
+
+    return filenames
+
+def _write_chunk(columns, start, chunk):
+    '''
+    Writes a chunk of parsed CSV rows to the memory-mapped column files.
+
+    '''
+
+    if len(chunk) == 0: return
+
+    values = np.array(chunk, dtype=np.float64)
+    for index, column in enumerate(columns):
+        column[start:start + len(values)] = values[:, index]
\ No newline at end of file
@@ -0,0 +1,337 @@
+import math
+import numpy as np
+
+def as_points(value):
+    '''
+    Converts a value to a two-dimensional array of points.
+
+    :param value:
+        An array-like object of points (i.e. a list of tuples, :class:`mathanim.utils.Vector2`
+        objects, or a numpy array with shape ``(n, 2)``).
+    :returns:
+        A numpy array of floats with shape ``(n, 2)``.
+
+    '''
+
+    if value is None: return np.empty((0, 2), dtype=np.float64)
+    if not isinstance(value, np.ndarray):
+        value = [(point.x, point.y) if hasattr(point, 'x') else point for point in value]
+
+    return np.asarray(value, dtype=np.float64).reshape(-1, 2)
+
+def matrix_to_array(matrix):
+    '''
+    Converts a :class:`cairo.Matrix` to an affine transformation in numpy form.
+
+    :param matrix:
+        The :class:`cairo.Matrix` to convert.
+    :returns:
+        A tuple containing the 2x2 linear part of the transformation (applied to row vectors)
+        and the translation component.
+
+    '''
+
+    linear = np.array([[matrix.xx, matrix.yx], [matrix.xy, matrix.yy]], dtype=np.float64)
+    translation = np.array([matrix.x0, matrix.y0], dtype=np.float64)
+    return linear, translation
+
+def to_device(points, matrix):
+    '''
+    Transforms an array of points from user space to device space.
+
+    :param points:
+        A numpy array of points with shape ``(n, 2)``.
+    :param matrix:
+        The :class:`cairo.Matrix` mapping user space to device space.
+    :returns:
+        A numpy array of the transformed points with shape ``(n, 2)``.
+
+    '''
+
+    linear, translation = matrix_to_array(matrix)
+    return points @ linear + translation
+
+def simplify(points, tolerance):
+    '''
+    Simplifies a polyline so that it deviates from the original by at most the specified tolerance.
+
+    :note:
+        The polyline is first decimated by dropping consecutive points that fall into the same
+        cell of a grid whose cells are the size of the tolerance. The remaining points are then
+        simplified using the Douglas-Peucker algorithm. Both passes are vectorized, so the cost is
+        proportional to the number of input points only in the (cheap) decimation pass.
+
+        Non-finite points (i.e. NaN) act as breaks in the polyline and are always kept.
+
+    :param points:
+        A numpy array of points with shape ``(n, 2)``, given in the space that the tolerance is
+        measured in (typically device space).
+    :param tolerance:
+        The maximum allowed deviation. A tolerance of zero or less disables simplification.
+    :returns:
+        A sorted numpy array containing the indices of the points that should be kept.
+
+    '''
+
+    n = len(points)
+    if n <= 2 or tolerance <= 0: return np.arange(n)
+
+    finite = np.isfinite(points).all(axis=1)
+
+    # Grid decimation: keep a point only if it lies in a different cell than its predecessor.
+    cells = np.floor(np.where(finite[:, None], points, 0) / tolerance)
+    keep = np.empty(n, dtype=bool)
+    keep[0] = keep[-1] = True
+    keep[1:-1] = (cells[1:-1] != cells[:-2]).any(axis=1)
+
+    # Breaks in the polyline (and the points either side of them) must survive simplification.
+    forced = ~finite
+    forced[1:] |= ~finite[:-1]
+    forced[:-1] |= ~finite[1:]
+    keep |= forced
+
+    indices = np.flatnonzero(keep)
+    if len(indices) <= 2: return indices
+
+    return indices[_douglas_peucker(points[indices], forced[indices], tolerance)]
+
+def _douglas_peucker(points, forced, tolerance):
+    '''
+    Iterative Douglas-Peucker simplification.
+
+    :param points:
+        A numpy array of points with shape ``(n, 2)``.
+    :param forced:
+        A boolean mask of points that must be kept.
+    :param tolerance:
+        The maximum allowed perpendicular deviation.
+    :returns:
+        A sorted numpy array containing the indices of the points that should be kept.
+
+    '''
+
+    n = len(points)
+    keep = forced.copy()
+    keep[0] = keep[-1] = True
+
+    # Seed the stack with the spans between consecutive forced points.
+    anchors = np.flatnonzero(keep)
+    stack = [(a, b) for a, b in zip(anchors[:-1], anchors[1:]) if b - a > 1]
+    while stack:
+        start, end = stack.pop()
+        a, b = points[start], points[end]
+        if not (np.isfinite(a).all() and np.isfinite(b).all()): continue
+
+        interior = points[start + 1:end]
+        direction = b - a
+        length = math.hypot(direction[0], direction[1])
+        if length == 0:
+            distances = np.hypot(*(interior - a).T)
+        else:
+            offset = interior - a
+            distances = np.abs(offset[:, 0] * direction[1] - offset[:, 1] * direction[0]) / length
+
+        index = int(np.argmax(distances))
+        if distances[index] > tolerance:
+            split = start + 1 + index
+            keep[split] = True
+            if split - start > 1: stack.append((start, split))
+            if end - split > 1: stack.append((split, end))
+
+    return np.flatnonzero(keep)
+
+def append_polyline(render_context, points, closed=False):
+    '''
+    Appends a polyline to the current path of a :class:`cairo.Context`.
+
+    :note:
+        Non-finite points (i.e. NaN) break the polyline into separate sub-paths.
+
+    :param render_context:
+        The :class:`cairo.Context` whose path to append to.
+    :param points:
+        A numpy array of points with shape ``(n, 2)``.
+    :param closed:
+        Indicates whether the polyline should be closed. Defaults to ``False``.
+
+    '''
+
+    move = True
+    line_to, move_to = render_context.line_to, render_context.move_to
+    for x, y in points.tolist():
+        if not (math.isfinite(x) and math.isfinite(y)):
+            move = True
+            continue
+
+        if move:
+            move_to(x, y)
+            move = False
+        else:
+            line_to(x, y)
+
+    if closed and not move:
+        render_context.close_path()
+
+def cumulative_lengths(points):
+    '''
+    Computes the cumulative arc length along a polyline.
+
+    :note:
+        Segments touching a non-finite point (i.e. a break in the polyline) have zero length.
+
+    :param points:
+        A numpy array of points with shape ``(n, 2)``.
+    :returns:
+        A numpy array with shape ``(n,)`` whose i-th element is the length of the
+        polyline from the first point to the i-th point.
+
+    '''
+
+    lengths = np.zeros(len(points), dtype=np.float64)
+    if len(points) < 2: return lengths
+
+    segments = np.diff(points, axis=0)
+    segment_lengths = np.hypot(segments[:, 0], segments[:, 1])
+    segment_lengths[~np.isfinite(segment_lengths)] = 0
+
+    np.cumsum(segment_lengths, out=lengths[1:])
+    return lengths
+
+def point_at_length(points, lengths, distance):
+    '''
+    Finds the point at the specified arc length along a polyline using a binary search.
+
+    :param points:
+        A numpy array of points with shape ``(n, 2)``.
+    :param lengths:
+        The cumulative arc lengths of the polyline (see :func:`cumulative_lengths`).
+    :param distance:
+        The arc length, measured from the first point. This may also be a numpy array of lengths.
+    :returns:
+        A tuple containing the index of the first point past the specified length
+        and the interpolated point (or array of points).
+
+    '''
+
+    distance = np.clip(distance, 0, lengths[-1])
+    index = np.clip(np.searchsorted(lengths, distance, side='right'), 1, len(points) - 1)
+
+    start, end = lengths[index - 1], lengths[index]
+    span = end - start
+    with np.errstate(invalid='ignore', divide='ignore'):
+        t = np.where(span > 0, (distance - start) / span, 0)
+
+    a, b = points[index - 1], points[index]
+    point = a + (b - a) * np.expand_dims(t, -1)
+    return index, point
+
+def resample(points, count, closed=False):
+    '''
+    Resamples a polyline to the specified number of points, evenly spaced by arc length.
+
+    :param points:
+        A numpy array of points with shape ``(n, 2)``.
+    :param count:
+        The number of points in the resampled polyline.
+    :param closed:
+        Indicates whether the polyline is closed (i.e. the last point joins the first).
+        Defaults to ``False``.
+    :returns:
+        A numpy array of points with shape ``(count, 2)``.
+
+    '''
+
+    if len(points) == 0: return np.zeros((count, 2), dtype=np.float64)
+    if closed: points = np.concatenate((points, points[:1]))
+    if len(points) == 1: return np.repeat(points, count, axis=0)
+
+    lengths = cumulative_lengths(points)
+    distances = np.linspace(0, lengths[-1], count, endpoint=not closed)
+    _, result = point_at_length(points, lengths, distances)
+    return result
+
+def align(source, destination, closed=False):
+    '''
+    Reorders the points of a polyline so that they correspond as closely as possible
+    to the points of another polyline with the same number of points.
+
+    :note:
+        For closed polylines, every cyclic shift (in both orientations) is considered and the one
+        minimizing the total squared distance between corresponding points (after centering both
+        polylines) is chosen. The shifts are scored simultaneously using a FFT cross-correlation.
+
+    :param source:
+        A numpy array of points with shape ``(n, 2)``.
+    :param destination:
+        A numpy array of points with shape ``(n, 2)`` to reorder.
+    :param closed:
+        Indicates whether the polylines are closed. Defaults to ``False``.
+        Open polylines are only ever reversed.
+    :returns:
+        The reordered destination points.
+
+    '''
+
+    a = source - source.mean(axis=0)
+    candidates = [destination, destination[::-1]]
+    if not closed:
+        costs = [np.square(a - (b - b.mean(axis=0))).sum() for b in candidates]
+        return candidates[int(np.argmin(costs))]
+
+    best, best_score = destination, -np.inf
+    fft_a = np.conj(np.fft.rfft(a, axis=0))
+    for b in candidates:
+        # correlation[k] = sum_i a_i . b_(i + k); maximizing it minimizes sum_i |a_i - b_(i + k)|^2.
+        centered = b - b.mean(axis=0)
+        correlation = np.fft.irfft(fft_a * np.fft.rfft(centered, axis=0), n=len(b), axis=0).sum(axis=1)
+        shift = int(np.argmax(correlation))
+        if correlation[shift] > best_score:
+            best, best_score = np.roll(b, -shift, axis=0), correlation[shift]
+
+    return best
+
+def append_polygons(render_context, polygons):
+    '''
+    Appends closed polygons to the current path of a :class:`cairo.Context`.
+
+    :param render_context:
+        The :class:`cairo.Context` whose path to append to.
+    :param polygons:
+        A numpy array (or nested list) of polygons with shape ``(n, k, 2)``.
+
+    '''
+
+    if isinstance(polygons, np.ndarray):
+        polygons = polygons.tolist()
+
+    line_to, move_to, close_path = render_context.line_to, render_context.move_to, render_context.close_path
+    for polygon in polygons:
+        move_to(*polygon[0])
+        for x, y in polygon[1:]:
+            line_to(x, y)
+
+        close_path()
+
+def rotation_matrix(x=0, y=0, z=0):
+    '''
+    Creates a three-dimensional rotation matrix.
+
+    :note:
+        The rotations are applied about the x-axis first, then the y-axis and finally the z-axis.
+
+    :param x:
+        The rotation about the x-axis, in radians. Defaults to 0.
+    :param y:
+        The rotation about the y-axis, in radians. Defaults to 0.
+    :param z:
+        The rotation about the z-axis, in radians. Defaults to 0.
+    :returns:
+        A 3x3 numpy array.
+
+    '''
+
+    cx, sx, cy, sy, cz, sz = math.cos(x), math.sin(x), math.cos(y), math.sin(y), math.cos(z), math.sin(z)
+    rx = np.array([[1, 0, 0], [0, cx, -sx], [0, sx, cx]])
+    ry = np.array([[cy, 0, sy], [0, 1, 0], [-sy, 0, cy]])
+    rz = np.array([[cz, -sz, 0], [sz, cz, 0], [0, 0, 1]])
+    return rz @ ry @ rx
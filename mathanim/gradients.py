@@ -0,0 +1,482 @@
+import cairo
+import numpy as np
+from colour import Color
+from abc import ABC, abstractmethod
+from mathanim.errors import ArgumentError
+from mathanim.utils import convert_colour, convert_vector2
+
+class Gradient(ABC):
+    '''
+    The base class for gradients that can be used in place of a solid fill colour.
+
+    :note:
+        The cairo pattern of a gradient is built the first time it is needed and reused until the
+        stops or geometry of the gradient change, so an unchanged gradient costs nothing per frame.
+        The geometry of a gradient is given in the local space of the object it fills.
+
+        The stops can be animated through :attr:`stop_array`, which holds them as a numpy array
+        that a :class:`mathanim.actions.Ramp` interpolates directly. For example,
+        ``Animation(shape, {'fill_colour.stop_array': Ramp(stop_array(['red', 'blue']), stop_array(['blue', 'red']), 2)})``
+        fades between two gradients; the pattern is rebuilt on the frames where the stops change
+        and reused once the ramp has finished.
+
+    '''
+
+    def __init__(self, stops=None, extend='pad'):
+        '''
+        Initializes an instance of :class:`Gradient`.
+
+        :param stops:
+            A list of colour stops. Each stop is a colour (the stops are then spaced evenly),
+            a tuple of the form ``(offset, colour)`` or a tuple of the form ``(offset, colour, opacity)``,
+            where the offset is a value from 0 to 1. A numpy array of stops (see :func:`stop_array`)
+            is also accepted. Defaults to ``None``, meaning that the gradient does not use colour stops.
+        :param extend:
+            How the gradient is extended beyond its geometry: 'pad', 'repeat', 'reflect' or 'none'.
+            Defaults to 'pad'.
+
+        '''
+
+        self.__stops = []
+        if stops is not None:
+            self.stops = stops
+
+        self.extend = extend
+
+        self._pattern = None
+        self._pattern_key = None
+
+    @property
+    def stops(self):
+        '''
+        Gets the colour stops of the gradient as a list of ``(offset, colour, opacity)`` tuples.
+
+        '''
+
+        return self.__stops
+
+    @stops.setter
+    def stops(self, value):
+        '''
+        Sets the colour stops of the gradient.
+
+        '''
+
+        stops = _parse_stops(value)
+        if len(stops) == 0:
+            raise ArgumentError('A gradient requires at least one colour stop.')
+
+        self.__stops = stops
+
+    @property
+    def stop_array(self):
+        '''
+        Gets the colour stops of the gradient as a numpy array with shape ``(n, 5)``, where each row
+        is of the form ``(offset, red, green, blue, opacity)``.
+
+        '''
+
+        return stop_array(self.stops)
+
+    @stop_array.setter
+    def stop_array(self, value):
+        '''
+        Sets the colour stops of the gradient from a numpy array with shape ``(n, 5)``.
+
+        '''
+
+        self.stops = value
+
+    @property
+    def extend(self):
+        '''
+        Gets how the gradient is extended beyond its geometry.
+
+        '''
+
+        return self.__extend
+
+    @extend.setter
+    def extend(self, value):
+        '''
+        Sets how the gradient is extended beyond its geometry.
+
+        '''
+
+        if value not in _EXTEND_MODES:
+            raise ArgumentError('Invalid gradient extend mode \'{}\'. Expected one of {}.'.format(value, ', '.join(_EXTEND_MODES)))
+
+        self.__extend = value
+
+    def get_pattern(self):
+        '''
+        Gets the cairo pattern of this gradient, building it only if the gradient changed.
+
+        :returns:
+            A :class:`cairo.Pattern`.
+
+        '''
+
+        key = (self._geometry_key(), tuple((offset, colour.rgb, opacity) for offset, colour, opacity in self.stops), self.extend)
+        if self._pattern is None or key != self._pattern_key:
+            pattern = self._create_pattern()
+            pattern.set_extend(getattr(cairo, _EXTEND_MODES[self.extend]))
+            self._pattern, self._pattern_key = pattern, key
+
+        return self._pattern
+
+    def __getstate__(self):
+        '''
+        Gets the state of this gradient for copying, excluding the cairo pattern (which cannot be copied).
+
+        '''
+
+        state = self.__dict__.copy()
+        state['_pattern'] = None
+        state['_pattern_key'] = None
+        return state
+
+    def _add_stops(self, pattern):
+        '''
+        Adds the colour stops of this gradient to a :class:`cairo.Gradient`.
+
+        '''
+
+        for offset, colour, opacity in self.stops:
+            pattern.add_color_stop_rgba(offset, *colour.rgb, opacity)
+
+    @abstractmethod
+    def _geometry_key(self):
+        '''
+        Gets a hashable value that changes whenever the geometry of the gradient changes.
+
+        '''
+
+        pass
+
+    @abstractmethod
+    def _create_pattern(self):
+        '''
+        Builds the cairo pattern of this gradient.
+
+        '''
+
+        pass
+
+class LinearGradient(Gradient):
+    '''
+    A gradient that varies along a line.
+
+    '''
+
+    def __init__(self, start, end, stops, extend='pad'):
+        '''
+        Initializes an instance of :class:`LinearGradient`.
+
+        :param start:
+            The point where the gradient starts (offset 0).
+        :param end:
+            The point where the gradient ends (offset 1).
+        :param stops:
+            A list of colour stops (see :class:`Gradient`).
+        :param extend:
+            How the gradient is extended beyond its ends. Defaults to 'pad'.
+
+        '''
+
+        super().__init__(stops, extend)
+
+        self.start = start
+        self.end = end
+
+    @property
+    def start(self):
+        '''
+        Gets the point where the gradient starts.
+
+        '''
+
+        return self.__start
+
+    @start.setter
+    def start(self, value):
+        '''
+        Sets the point where the gradient starts.
+
+        '''
+
+        self.__start = convert_vector2(value)
+
+    @property
+    def end(self):
+        '''
+        Gets the point where the gradient ends.
+
+        '''
+
+        return self.__end
+
+    @end.setter
+    def end(self, value):
+        '''
+        Sets the point where the gradient ends.
+
+        '''
+
+        self.__end = convert_vector2(value)
+
+    def _geometry_key(self):
+        return (self.start.x, self.start.y, self.end.x, self.end.y)
+
+    def _create_pattern(self):
+        pattern = cairo.LinearGradient(self.start.x, self.start.y, self.end.x, self.end.y)
+        self._add_stops(pattern)
+        return pattern
+
+class RadialGradient(Gradient):
+    '''
+    A gradient that varies between two circles.
+
+    '''
+
+    def __init__(self, centre, radius, stops, focus=None, focus_radius=0, extend='pad'):
+        '''
+        Initializes an instance of :class:`RadialGradient`.
+
+        :param centre:
+            The centre of the outer circle (offset 1).
+        :param radius:
+            The radius of the outer circle.
+        :param stops:
+            A list of colour stops (see :class:`Gradient`).
+        :param focus:
+            The centre of the inner circle (offset 0). Defaults to the centre of the outer circle.
+        :param focus_radius:
+            The radius of the inner circle. Defaults to 0.
+        :param extend:
+            How the gradient is extended beyond its circles. Defaults to 'pad'.
+
+        '''
+
+        super().__init__(stops, extend)
+
+        self.centre = centre
+        self.radius = radius
+        self.focus = focus
+        self.focus_radius = focus_radius
+
+    @property
+    def centre(self):
+        '''
+        Gets the centre of the outer circle.
+
+        '''
+
+        return self.__centre
+
+    @centre.setter
+    def centre(self, value):
+        '''
+        Sets the centre of the outer circle.
+
+        '''
+
+        self.__centre = convert_vector2(value)
+
+    @property
+    def focus(self):
+        '''
+        Gets the centre of the inner circle.
+
+        '''
+
+        return self.__focus if self.__focus is not None else self.centre
+
+    @focus.setter
+    def focus(self, value):
+        '''
+        Sets the centre of the inner circle. A value of ``None`` means the centre of the outer circle.
+
+        '''
+
+        self.__focus = None if value is None else convert_vector2(value)
+
+    def _geometry_key(self):
+        return (self.focus.x, self.focus.y, self.focus_radius, self.centre.x, self.centre.y, self.radius)
+
+    def _create_pattern(self):
+        pattern = cairo.RadialGradient(self.focus.x, self.focus.y, self.focus_radius, self.centre.x, self.centre.y, self.radius)
+        self._add_stops(pattern)
+        return pattern
+
+class MeshGradient(Gradient):
+    '''
+    A gradient made of quadrilateral patches whose corners are coloured individually.
+
+    '''
+
+    def __init__(self, patches, extend='none'):
+        '''
+        Initializes an instance of :class:`MeshGradient`.
+
+        :param patches:
+            A list of patches. Each patch is a tuple containing a list of its four corners and
+            a list of the four corresponding colours (or ``(colour, opacity)`` tuples).
+        :param extend:
+            How the gradient is extended beyond its patches. Defaults to 'none'.
+
+        '''
+
+        super().__init__(None, extend)
+        self.patches = patches
+
+    @property
+    def patches(self):
+        '''
+        Gets the patches of the gradient as a list of ``(corners, colours)`` tuples, where the colours
+        are ``(colour, opacity)`` tuples.
+
+        '''
+
+        return self.__patches
+
+    @patches.setter
+    def patches(self, value):
+        '''
+        Sets the patches of the gradient.
+
+        '''
+
+        patches = []
+        for corners, colours in value:
+            corners = [convert_vector2(corner) for corner in corners]
+            colours = [(convert_colour(colour), 1.0) if isinstance(colour, (str, Color)) else
+                       (convert_colour(colour[0]), float(colour[1])) for colour in colours]
+
+            if len(corners) != 4 or len(colours) != 4:
+                raise ArgumentError('A mesh gradient patch requires exactly four corners and four colours.')
+
+            patches.append((corners, colours))
+
+        self.__patches = patches
+
+    def _geometry_key(self):
+        return tuple((tuple((corner.x, corner.y) for corner in corners), tuple((colour.rgb, opacity) for colour, opacity in colours))
+                     for corners, colours in self.patches)
+
+    def _create_pattern(self):
+        pattern = cairo.MeshPattern()
+        for corners, colours in self.patches:
+            pattern.begin_patch()
+            pattern.move_to(corners[0].x, corners[0].y)
+            for corner in corners[1:]:
+                pattern.line_to(corner.x, corner.y)
+
+            for i, (colour, opacity) in enumerate(colours):
+                pattern.set_corner_color_rgba(i, *colour.rgb, opacity)
+
+            pattern.end_patch()
+
+        return pattern
+
+# Maps the extend modes of a gradient to the names of the corresponding cairo constants.
+_EXTEND_MODES = {
+    'none': 'EXTEND_NONE',
+    'repeat': 'EXTEND_REPEAT',
+    'reflect': 'EXTEND_REFLECT',
+    'pad': 'EXTEND_PAD'
+}
+
+def _parse_stops(value):
+    '''
+    Converts colour stops given in any of the forms accepted by :class:`Gradient` to a list of
+    ``(offset, colour, opacity)`` tuples.
+
+    '''
+
+    if isinstance(value, np.ndarray):
+        if value.ndim != 2 or value.shape[1] != 5:
+            raise ArgumentError('An array of colour stops must have shape (n, 5).')
+
+        # Interpolated colours may overshoot slightly (e.g. with an easing function).
+        rgb = np.clip(value[:, 1:4], 0, 1)
+        return [(float(row[0]), Color(rgb=tuple(colour)), float(row[4])) for row, colour in zip(value, rgb.tolist())]
+
+    value = list(value)
+    stops = []
+    for i, stop in enumerate(value):
+        if isinstance(stop, (str, Color)):
+            stop = (i / max(len(value) - 1, 1), stop)
+
+        offset, colour, *opacity = stop
+        stops.append((float(offset), convert_colour(colour), float(opacity[0]) if opacity else 1.0))
+
+    return stops
+
+def stop_array(stops):
+    '''
+    Converts a list of colour stops to a numpy array, e.g. to animate :attr:`Gradient.stop_array`.
+
+    :param stops:
+        A list of colour stops (see :class:`Gradient`).
+    :returns:
+        A numpy array with shape ``(n, 5)`` where each row is of the form ``(offset, red, green, blue, opacity)``.
+
+    '''
+
+    return np.array([(offset, *colour.rgb, opacity) for offset, colour, opacity in _parse_stops(stops)],
+                    dtype=np.float64).reshape(-1, 5)
+
+def set_source(render_context, paint, opacity=1):
+    '''
+    Sets the source of a :class:`cairo.Context` to a solid colour or gradient.
+
+    :param render_context:
+        The :class:`cairo.Context` whose source to set.
+    :param paint:
+        A :class:`colour.Color` or :class:`Gradient`.
+    :param opacity:
+        The opacity of a solid colour. Defaults to 1. Gradients ignore this value (see :func:`fill`).
+
+    '''
+
+    if isinstance(paint, Gradient):
+        render_context.set_source(paint.get_pattern())
+    else:
+        render_context.set_source_rgba(*paint.rgb, opacity)
+
+def fill(render_context, paint, opacity=1, preserve=False):
+    '''
+    Fills the current path of a :class:`cairo.Context` with a solid colour or gradient.
+
+    :note:
+        A cairo pattern has no opacity of its own, so a translucent gradient fill is painted
+        with an alpha through a clip of the path rather than rebuilding the pattern with
+        different stop colours (which would defeat the pattern cache when fading).
+
+    :param render_context:
+        The :class:`cairo.Context` to fill.
+    :param paint:
+        A :class:`colour.Color` or :class:`Gradient`.
+    :param opacity:
+        The opacity of the fill. Defaults to 1.
+    :param preserve:
+        Indicates whether the current path should be kept. Defaults to ``False``.
+
+    '''
+
+    set_source(render_context, paint, opacity)
+    if not isinstance(paint, Gradient) or opacity >= 1:
+        if preserve:
+            render_context.fill_preserve()
+        else:
+            render_context.fill()
+
+        return
+
+    render_context.save()
+    render_context.clip_preserve()
+    render_context.paint_with_alpha(opacity)
+    render_context.restore()
+    if not preserve:
+        render_context.new_path()
@@ -0,0 +1,177 @@
+import math
+import numpy as np
+
+def force_directed(node_count, edges, iterations=300, seed=0, initial_positions=None, gravity=0.3):
+    '''
+    Computes a force-directed (Fruchterman-Reingold) layout of a graph.
+
+    :note:
+        Repulsive forces are approximated with a vectorized Barnes-Hut scheme: the nodes are
+        binned into a hierarchy of grids and, at each level, every node is repelled by the centres
+        of mass of the cells in its interaction list (the children of the cells adjacent to its
+        parent cell that are not themselves adjacent to its cell). Nodes in adjacent cells of the
+        finest grid repel each other exactly. The grid is fitted to the bulk of the nodes (outliers
+        are clamped into its border cells) and is subdivided until the finest cells hold about two
+        nodes each, so every level costs O(n) and the exact pass stays linear unless many nodes
+        coincide. The depth is capped at 10 levels.
+
+    :param node_count:
+        The number of nodes in the graph.
+    :param edges:
+        An array-like object of node index pairs with shape ``(m, 2)``.
+    :param iterations:
+        The number of iterations to run. Defaults to 300.
+    :param seed:
+        The seed of the random initial layout. Defaults to 0.
+    :param initial_positions:
+        An optional array-like object of initial node positions with shape ``(node_count, 2)``.
+        Defaults to random positions in the unit square.
+    :param gravity:
+        The strength of a spring pulling every node towards the centroid of the layout, which
+        keeps disconnected nodes from drifting away. Defaults to 0.3.
+    :returns:
+        A numpy array with shape ``(iterations + 1, node_count, 2)`` containing the
+        positions of the nodes after each iteration (the first entry is the initial layout).
+
+    '''
+
+    edges = np.asarray(edges, dtype=np.int64).reshape(-1, 2)
+    if initial_positions is None:
+        positions = np.random.default_rng(seed).uniform(0, 1, (node_count, 2))
+    else:
+        positions = np.array(initial_positions, dtype=np.float64).reshape(node_count, 2)
+
+    steps = np.empty((iterations + 1, node_count, 2), dtype=np.float32)
+    steps[0] = positions
+    if node_count < 2:
+        steps[1:] = positions
+        return steps
+
+    k = 1 / math.sqrt(node_count)
+    temperature = 0.1
+    for i in range(iterations):
+        forces = _repulsion(positions, k * k)
+        forces -= gravity * (positions - positions.mean(axis=0))
+
+        if len(edges) > 0:
+            delta = positions[edges[:, 0]] - positions[edges[:, 1]]
+            distance = np.hypot(delta[:, 0], delta[:, 1])[:, None]
+            attraction = delta * distance / k
+            for axis in range(2):
+                forces[:, axis] -= np.bincount(edges[:, 0], weights=attraction[:, axis], minlength=node_count)
+                forces[:, axis] += np.bincount(edges[:, 1], weights=attraction[:, axis], minlength=node_count)
+
+        # Limit the displacement of each node by the temperature, which cools linearly.
+        magnitude = np.maximum(np.hypot(forces[:, 0], forces[:, 1]), 1e-12)[:, None]
+        limit = temperature * (1 - i / iterations)
+        positions += forces / magnitude * np.minimum(magnitude, limit)
+        steps[i + 1] = positions
+
+    return steps
+
+def _repulsion(positions, k2):
+    '''
+    Approximates the repulsive force on every node.
+
+    :param positions:
+        A numpy array of node positions with shape ``(n, 2)``.
+    :param k2:
+        The square of the ideal edge length.
+    :returns:
+        A numpy array of forces with shape ``(n, 2)``.
+
+    '''
+
+    n = len(positions)
+
+    # Fit the grid to the bulk of the nodes so that a few outliers do not squeeze everything else
+    # into a handful of cells; the outliers are clamped into the border cells.
+    low, high = np.percentile(positions, (1, 99), axis=0)
+    size = max(float((high - low).max()), 1e-9)
+    origin = (low + high - size) / 2 - size * 0.01
+    normalized = np.clip((positions - origin) / (size * 1.02), 0, 1)
+
+    # Subdivide the finest grid until its cells hold about two nodes each. The exact pass costs
+    # the sum of the squared cell counts, so that is what is bounded (rather than n alone, which
+    # says nothing about how tightly the nodes are packed).
+    levels = int(np.clip(math.ceil(math.log(max(n / 2, 1), 4)), 2, 10))
+    while levels < 10:
+        resolution = 2**levels
+        cells = np.minimum((normalized * resolution).astype(np.int64), resolution - 1)
+        counts = np.bincount(cells[:, 1] * resolution + cells[:, 0], minlength=resolution * resolution)
+        if np.dot(counts, counts) <= 3 * n: break
+        levels += 1
+
+    forces = np.zeros_like(positions)
+
+    # The interaction list of a node contains the cells whose parent is adjacent to the parent of
+    # the node's cell but which are not adjacent to the node's cell. Relative to the node's cell,
+    # this list only depends on which corner of its parent the cell occupies.
+    interaction_offsets = []
+    for parity in range(4):
+        px, py = parity % 2, parity // 2
+        interaction_offsets.append(np.array([(dx, dy) for dy in range(-3, 4) for dx in range(-3, 4)
+                                             if max(abs(dx), abs(dy)) > 1 and abs((px + dx) // 2) <= 1
+                                             and abs((py + dy) // 2) <= 1], dtype=np.int64))
+
+    for level in range(2, levels + 1):
+        resolution = 2**level
+        cells = np.minimum((normalized * resolution).astype(np.int64), resolution - 1)
+        cx, cy = cells[:, 0], cells[:, 1]
+        ids = cy * resolution + cx
+
+        # Aggregate the nodes into a grid padded by three empty cells on every side so that
+        # interaction lists never need to be bounds checked (empty cells exert no force).
+        padded = resolution + 6
+        padded_ids = (cy + 3) * padded + (cx + 3)
+        counts = np.bincount(padded_ids, minlength=padded * padded)
+        centres = np.column_stack([np.bincount(padded_ids, weights=positions[:, axis], minlength=len(counts)) for axis in range(2)])
+        centres /= np.maximum(counts, 1)[:, None]
+
+        parities = (cx % 2) + 2 * (cy % 2)
+        for parity in range(4):
+            members = np.flatnonzero(parities == parity)
+            if len(members) == 0: continue
+
+            offsets = interaction_offsets[parity]
+            targets = padded_ids[members, None] + (offsets[:, 1] * padded + offsets[:, 0])[None, :]
+
+            # Most of the cells in the interaction lists of the finer levels are empty, so only the
+            # occupied ones are visited.
+            occupied = counts[targets] > 0
+            sources = np.broadcast_to(members[:, None], targets.shape)[occupied]
+            targets = targets[occupied]
+
+            delta = positions[sources] - centres[targets]
+            weight = counts[targets] * k2 / np.maximum(delta[:, 0] * delta[:, 0] + delta[:, 1] * delta[:, 1], 1e-12)
+            for axis in range(2):
+                forces[:, axis] += np.bincount(sources, weights=delta[:, axis] * weight, minlength=n)
+
+    counts = counts.reshape(padded, padded)[3:-3, 3:-3].ravel()
+
+    # Nodes in adjacent cells of the finest grid interact exactly.
+    order = np.argsort(ids, kind='stable')
+    starts = np.searchsorted(ids[order], np.arange(len(counts)))
+    for dx, dy in [(dx, dy) for dy in range(-1, 2) for dx in range(-1, 2)]:
+        neighbour = cells + (dx, dy)
+        valid = (neighbour >= 0).all(axis=1) & (neighbour < resolution).all(axis=1)
+        nodes = np.flatnonzero(valid)
+        neighbour_ids = neighbour[nodes, 1] * resolution + neighbour[nodes, 0]
+
+        # Enumerate every (node, member of neighbouring cell) pair without a Python loop.
+        repeats = counts[neighbour_ids]
+        total = int(repeats.sum())
+        if total == 0: continue
+
+        sources = np.repeat(nodes, repeats)
+        first = np.repeat(starts[neighbour_ids] - (np.cumsum(repeats) - repeats), repeats)
+        others = order[first + np.arange(total)]
+
+        distinct = sources != others
+        sources, others = sources[distinct], others[distinct]
+        delta = positions[sources] - positions[others]
+        weight = k2 / np.maximum(delta[:, 0] * delta[:, 0] + delta[:, 1] * delta[:, 1], 1e-12)
+        for axis in range(2):
+            forces[:, axis] += np.bincount(sources, weights=delta[:, axis] * weight, minlength=n)
+
+    return forces
\ No newline at end of file
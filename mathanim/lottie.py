@@ -0,0 +1,448 @@
+import copy
+import math
+import numpy as np
+from colour import Color
+from intervaltree import Interval
+from mathanim import gradients
+from mathanim.errors import ArgumentError
+from mathanim.actions import Ramp, Morph
+from mathanim.sequences import Sequence
+from mathanim.core import Scene, RemoveTrigger
+from mathanim.objects import Group, Path, Rectangle
+
+# The version of the Lottie format that is written.
+_VERSION = '5.7.0'
+
+# The offset, in frames, of the keyframes holding the value of a property just before and after it jumps.
+_EPSILON = 1e-3
+
+class _Value:
+    '''
+    An animatable value in the Lottie representation of an object.
+
+    '''
+
+    __slots__ = ('value',)
+
+    def __init__(self, value):
+        self.value = _round(value)
+
+def convert(scene, fps=60, sample_rate=None):
+    '''
+    Converts the timeline of a scene to a Lottie animation.
+
+    :note:
+        The timeline is never rasterized. Instead, the state of each object is evaluated only at the
+        times where its animation can change course: the ends of every linear :class:`Ramp` or
+        :class:`Morph` (including those chained in a :class:`Sequence`) and the start and end of
+        every timeline item. The object is linearly interpolated between these keyframes, exactly
+        like the ramps themselves. Any other sequence item (e.g. a :class:`Procedure` or a ramp with
+        a custom interpolation function) is baked into linear keyframes at the sample rate.
+
+        Only rectangles, paths and groups of these can be converted. The structure of an object
+        (e.g. whether it is filled or the number of vertices of a path) may not change over time.
+        Triggers other than object removal cannot be converted either. The focus of a radial
+        gradient is not converted.
+
+    :param scene:
+        The :class:`mathanim.core.Scene` to convert.
+    :param fps:
+        The frames per second of the animation. Defaults to 60.
+    :param sample_rate:
+        The number of keyframes per second used to bake sequence items that are not linear.
+        Defaults to the frames per second.
+    :returns:
+        A dictionary containing the Lottie animation (ready to be serialized as JSON).
+
+    '''
+
+    total_seconds = scene.total_seconds
+    total_frames = round(total_seconds * fps)
+    frames_per_sample = fps / (sample_rate or fps)
+    width, height = scene.settings.reference_width, scene.settings.reference_height
+
+    removals = {}
+    for trigger in scene._triggers:
+        if not isinstance(trigger, RemoveTrigger):
+            raise ArgumentError('Only removal triggers can be exported as a vector animation.')
+
+        object_id = id(trigger._func_args[0])
+        frame = round(trigger.time * fps) + trigger.frame_delay
+        removals[object_id] = min(removals.get(object_id, frame), frame)
+
+    # Group the timeline items by object (in draw order) as intervals of frames, like the renderer.
+    tracks = {}
+    for item in scene._items:
+        if item.scene_object is None: continue
+
+        begin, end = round(item.start * fps), round((item.end or total_seconds) * fps)
+        if end <= begin: continue
+
+        tracks.setdefault(id(item.scene_object), (item.scene_object, []))[1].append(Interval(begin, end, item))
+
+    camera_intervals = tracks.pop(id(scene.camera), (None, []))[1]
+    camera_content = _animate(scene.camera, camera_intervals, 0, total_frames, frames_per_sample,
+                              lambda camera: _camera_content(camera, width, height))
+    layers = [dict(ddd=0, ind=1, ty=3, nm='Camera', sr=1, ks=camera_content['ks'], ao=0, ip=0, op=total_frames, st=0)]
+
+    shape_layers = []
+    tracks = sorted(tracks.values(), key=lambda track: min(interval.begin for interval in track[1]))
+    for index, (scene_object, intervals) in enumerate(tracks):
+        in_point = min(interval.begin for interval in intervals)
+        out_point = min(removals.get(id(scene_object), total_frames), total_frames)
+        if out_point <= in_point: continue
+
+        content = _animate(scene_object, intervals, in_point, out_point, frames_per_sample, _layer_content)
+        shape_layers.append(dict(ddd=0, ind=index + 2, ty=4, nm='{} {}'.format(type(scene_object).__name__, index),
+                                 parent=1, sr=1, ks=content['ks'], ao=0, shapes=content['shapes'],
+                                 ip=in_point, op=out_point, st=0, bm=0))
+
+    # Lottie layers are listed from top to bottom.
+    layers.extend(reversed(shape_layers))
+    layers.append(_background_layer(scene.background_colour, width, height, len(tracks) + 2, total_frames))
+
+    return dict(v=_VERSION, fr=fps, ip=0, op=total_frames, w=width, h=height, nm='mathanim', ddd=0,
+                assets=[], layers=layers)
+
+def _animate(scene_object, intervals, in_point, out_point, frames_per_sample, content_func):
+    '''
+    Converts the animation of an object into Lottie properties with keyframes.
+
+    :param scene_object:
+        The object (in its initial state).
+    :param intervals:
+        The intervals of the timeline items of the object, in frames.
+    :param in_point:
+        The first frame of the object.
+    :param out_point:
+        The frame after the last frame of the object.
+    :param frames_per_sample:
+        The number of frames between the keyframes of baked sequence items.
+    :param content_func:
+        A function that converts an object to its Lottie representation, with :class:`_Value` leaves.
+    :returns:
+        The Lottie representation of the object, whose leaves are animated properties.
+
+    '''
+
+    intervals = sorted(intervals, key=lambda interval: interval.begin)
+
+    breakpoints = {in_point}
+    for interval in intervals:
+        last = interval.end - 1
+        breakpoints.update((interval.begin, last))
+
+        item = interval.data
+        if item.animation is None or item.duration <= 0 or last <= interval.begin: continue
+
+        # Map item-local times to frames (see Scene._item_time).
+        frames_per_second = (last - interval.begin) / item.duration
+        for instance in item.animation.sequence_instances:
+            times = _breakpoints(instance.sequence_item, instance.map_func is not None, frames_per_sample / frames_per_second)
+            breakpoints.update(interval.begin + min(max(time, 0), item.duration) * frames_per_second for time in times)
+
+    breakpoints = sorted(x for x in breakpoints if in_point <= x < out_point)
+
+    def evaluate(frame):
+        state = copy.deepcopy(scene_object)
+        for interval in intervals:
+            if interval.data.animation is not None and interval.begin <= frame:
+                Scene._animate_at(interval, frame, state)
+
+        return content_func(state)
+
+    def is_linear(a, b):
+        middle = (a + b) / 2
+        return any(x.data.animation is not None and x.begin <= middle <= x.end - 1 for x in intervals)
+
+    # Each key is a tuple of the form (frame, content, hold, limit), where hold indicates that the value is
+    # held until the next key. Sequence items may jump at a breakpoint (e.g. between chained ramps), so the
+    # value is also evaluated just before and after each breakpoint; these limit keys are dropped later if
+    # the value of a property turns out to be continuous.
+    keys = []
+    for i, frame in enumerate(breakpoints):
+        if i > 0 and is_linear(breakpoints[i - 1], frame) and frame - _EPSILON > breakpoints[i - 1]:
+            keys.append((frame - _EPSILON, evaluate(frame - _EPSILON), True, 'left'))
+
+        linear = i + 1 < len(breakpoints) and is_linear(frame, breakpoints[i + 1])
+        keys.append((frame, evaluate(frame), not linear, None))
+
+        if linear and frame + _EPSILON < breakpoints[i + 1]:
+            keys.append((frame + _EPSILON, evaluate(frame + _EPSILON), False, 'right'))
+
+    return _merge([key[1] for key in keys], [(frame, hold, limit) for frame, _, hold, limit in keys], type(scene_object).__name__)
+
+def _breakpoints(sequence_item, baked, step):
+    '''
+    Gets the times, relative to the start of a sequence item, between which its value is linear.
+
+    :param sequence_item:
+        The :class:`mathanim.sequences.SequenceItem`.
+    :param baked:
+        Indicates whether the item must be sampled (e.g. because its value is mapped by a custom function).
+    :param step:
+        The time, in seconds, between the samples of an item that is not linear.
+
+    '''
+
+    duration = sequence_item.duration
+    if not baked and isinstance(sequence_item, Sequence):
+        times = []
+        for item, offset in zip(sequence_item.items, sequence_item._time_intervals):
+            times.extend(offset + time for time in _breakpoints(item, False, step))
+
+        return times
+
+    linear = isinstance(sequence_item, (Ramp, Morph)) and sequence_item.func is Ramp.linear and \
+             getattr(sequence_item, 'map_func', Ramp._default_map_func) is Ramp._default_map_func
+
+    if baked or not linear:
+        return list(np.arange(0, duration, step)) + [duration]
+
+    return [0, duration]
+
+def _merge(contents, keys, name):
+    '''
+    Merges the Lottie representations of an object at several keyframes into a single representation
+    whose :class:`_Value` leaves are replaced with animated properties.
+
+    :param contents:
+        The representations at each keyframe.
+    :param keys:
+        A list of tuples of the form ``(frame, hold, limit)`` describing each keyframe (see :func:`_animate`).
+    :param name:
+        The name of the object, used in error messages.
+
+    '''
+
+    first = contents[0]
+    if isinstance(first, _Value):
+        if not all(isinstance(x, _Value) for x in contents):
+            raise ArgumentError('The structure of a {} object changes during its animation.'.format(name))
+
+        return _property([(frame, x.value, hold, limit) for x, (frame, hold, limit) in zip(contents, keys)])
+
+    if isinstance(first, dict):
+        if not all(isinstance(x, dict) and x.keys() == first.keys() for x in contents):
+            raise ArgumentError('The structure of a {} object changes during its animation.'.format(name))
+
+        return {key: _merge([x[key] for x in contents], keys, name) for key in first}
+
+    if isinstance(first, list):
+        if not all(isinstance(x, list) and len(x) == len(first) for x in contents):
+            raise ArgumentError('The structure of a {} object changes during its animation.'.format(name))
+
+        return [_merge([x[i] for x in contents], keys, name) for i in range(len(first))]
+
+    if not all(x == first for x in contents):
+        raise ArgumentError('The structure of a {} object changes during its animation.'.format(name))
+
+    return first
+
+def _property(series):
+    '''
+    Creates a Lottie property from a list of ``(frame, value, hold, limit)`` keyframes.
+
+    '''
+
+    if all(value == series[0][1] for _, value, _, _ in series):
+        return dict(a=0, k=series[0][1])
+
+    # Drop limit keys where the value does not jump, and keys that are equal to both of their neighbours.
+    keys = []
+    for i, (frame, value, hold, limit) in enumerate(series):
+        if limit is not None and 0 < i < len(series) - 1 and _continues(series[i - 1], series[i], series[i + 1]):
+            continue
+
+        if limit == 'right':
+            # The value jumps from the breakpoint to its right limit.
+            keys[-1] = keys[-1][:2] + (True,)
+
+        keys.append((frame, value, hold))
+
+    keys = [key for i, key in enumerate(keys) if i == 0 or i + 1 == len(keys) or
+            not (keys[i - 1][1] == key[1] == keys[i + 1][1])]
+
+    result = []
+    for i, (frame, value, hold) in enumerate(keys):
+        key = dict(t=round(frame, 3), s=value if isinstance(value, list) else [value])
+        if i + 1 < len(keys):
+            if hold:
+                key['h'] = 1
+            else:
+                key['o'] = dict(x=[0], y=[0])
+                key['i'] = dict(x=[1], y=[1])
+
+        result.append(key)
+
+    return dict(a=1, k=result)
+
+def _continues(previous, limit, following):
+    '''
+    Determines whether the value of a property at a limit key lies on the line between its neighbouring
+    keys (i.e. whether the value does not jump next to the limit key).
+
+    '''
+
+    try:
+        a, b, c = (_flatten(key[1]) for key in (previous, limit, following))
+        if not (a.shape == b.shape == c.shape): return False
+
+        expected = a + (c - a) * (limit[0] - previous[0]) / (following[0] - previous[0])
+        return bool(np.allclose(expected, b, rtol=0, atol=1e-2))
+    except (TypeError, ValueError):
+        return False
+
+def _flatten(value):
+    '''
+    Flattens the numbers in a property value (including shapes) into a numpy array.
+
+    '''
+
+    if isinstance(value, dict):
+        return np.concatenate([_flatten(value[key]) for key in ('v', 'i', 'o')])
+
+    return np.asarray(value, dtype=np.float64).ravel()
+
+def _round(value):
+    '''
+    Rounds the numbers in a value to keep the output small.
+
+    '''
+
+    if isinstance(value, (list, tuple)): return [_round(x) for x in value]
+    if isinstance(value, dict): return {key: _round(x) for key, x in value.items()}
+    if isinstance(value, bool): return value
+    if isinstance(value, (int, float, np.number)): return round(float(value), 3)
+    return value
+
+def _transform(scene_object):
+    '''
+    Gets the Lottie transform of an object (which is translated, rotated and then scaled).
+
+    '''
+
+    return dict(a=_Value([0, 0]), p=_Value([scene_object.position.x, scene_object.position.y]),
+                s=_Value([scene_object.scale.x * 100, scene_object.scale.y * 100]),
+                r=_Value(math.degrees(scene_object.rotation)), o=_Value(scene_object.opacity * 100))
+
+def _layer_content(scene_object):
+    '''
+    Gets the Lottie representation of an object drawn in a shape layer.
+
+    '''
+
+    return dict(ks=_transform(scene_object), shapes=_shape_items(scene_object))
+
+def _camera_content(camera, width, height):
+    '''
+    Gets the Lottie representation of a camera as the transform of a null layer that parents every shape layer.
+
+    '''
+
+    return dict(ks=dict(a=_Value([camera.position.x, camera.position.y]), p=_Value([width / 2, height / 2]),
+                        s=_Value([camera.zoom * 100, camera.zoom * 100]), r=_Value(-math.degrees(camera.rotation)),
+                        o=_Value(100)))
+
+def _shape_items(scene_object):
+    '''
+    Gets the Lottie shape items of an object, excluding its transform.
+
+    '''
+
+    if type(scene_object) is Group:
+        if scene_object.clip_mask is not None:
+            raise ArgumentError('Groups with a clip mask cannot be exported as a vector animation.')
+
+        # Lottie lists shapes from top to bottom.
+        return [dict(ty='gr', it=_shape_items(child) + [dict(_transform(child), ty='tr')])
+                for child in reversed(scene_object.children)]
+
+    if type(scene_object) is Rectangle:
+        items = [dict(ty='rc', d=1, p=_Value([0, 0]), s=_Value([scene_object.width, scene_object.height]),
+                      r=_Value(scene_object.border_radius))]
+    elif type(scene_object) is Path:
+        items = [dict(ty='sh', d=1, ks=_Value(shape)) for shape in _path_shapes(scene_object)]
+        items.append(dict(ty='tm', s=_Value(0), e=_Value(min(max(scene_object.percent_drawn, 0), 1) * 100), o=_Value(0), m=2))
+    else:
+        raise ArgumentError('{} objects cannot be exported as a vector animation.'.format(type(scene_object).__name__))
+
+    # The stroke is listed first since it is drawn over the fill.
+    if scene_object.stroke_colour is not None:
+        items.append(dict(ty='st', c=_Value(list(scene_object.stroke_colour.rgb) + [1]), o=_Value(scene_object.stroke_opacity * 100),
+                          w=_Value(scene_object.stroke_width), lc=1, lj=1, ml=10))
+
+    if scene_object.fill_colour is not None:
+        items.append(_fill(scene_object.fill_colour, scene_object.fill_opacity))
+
+    return items
+
+def _path_shapes(path):
+    '''
+    Gets the Lottie shapes of a path, one for each run of finite vertices.
+
+    '''
+
+    vertices = path.vertices
+    finite = np.isfinite(vertices).all(axis=1)
+    breaks = np.flatnonzero(~finite)
+    closed = path.closed and len(breaks) == 0
+
+    shapes = []
+    for run in np.split(vertices, breaks):
+        run = run[np.isfinite(run).all(axis=1)]
+        if len(run) == 0: continue
+
+        zeros = [[0, 0]] * len(run)
+        shapes.append(dict(c=closed, v=run.tolist(), i=zeros, o=zeros))
+
+    return shapes
+
+def _fill(paint, opacity):
+    '''
+    Gets the Lottie fill (or gradient fill) item of a solid colour or :class:`mathanim.gradients.Gradient`.
+
+    '''
+
+    if isinstance(paint, Color):
+        return dict(ty='fl', c=_Value(list(paint.rgb) + [1]), o=_Value(opacity * 100), r=1)
+
+    if isinstance(paint, gradients.LinearGradient):
+        start, end, kind = [paint.start.x, paint.start.y], [paint.end.x, paint.end.y], 1
+    elif isinstance(paint, gradients.RadialGradient):
+        start, end, kind = [paint.centre.x, paint.centre.y], [paint.centre.x + paint.radius, paint.centre.y], 2
+    else:
+        raise ArgumentError('{} fills cannot be exported as a vector animation.'.format(type(paint).__name__))
+
+    # The colour stops are followed by opacity stops (only if the gradient is translucent).
+    stops = [x for offset, colour, _ in paint.stops for x in (offset,) + tuple(colour.rgb)]
+    if any(stop_opacity < 1 for _, _, stop_opacity in paint.stops):
+        stops.extend(x for offset, _, stop_opacity in paint.stops for x in (offset, stop_opacity))
+
+    item = dict(ty='gf', o=_Value(opacity * 100), r=1, t=kind, s=_Value(start), e=_Value(end),
+                g=dict(p=len(paint.stops), k=_Value(stops)))
+
+    if kind == 2:
+        item.update(h=_Value(0), a=_Value(0))
+
+    return item
+
+def _background_layer(background, width, height, index, total_frames):
+    '''
+    Gets the Lottie layer of the background of a scene (in the reference frame, so it is not parented to the camera).
+
+    '''
+
+    layer = dict(ddd=0, ind=index, nm='Background', sr=1, ao=0, ip=0, op=total_frames, st=0, bm=0,
+                 ks=_merge([dict(a=_Value([0, 0]), p=_Value([0, 0]), s=_Value([100, 100]), r=_Value(0), o=_Value(100))],
+                           [(0, True, False)], 'background'))
+
+    if isinstance(background, Color):
+        layer.update(ty=1, sc=background.hex_l, sw=width, sh=height)
+    else:
+        shapes = [dict(ty='rc', d=1, p=_Value([width / 2, height / 2]), s=_Value([width, height]), r=_Value(0)),
+                  _fill(background, 1)]
+
+        layer.update(ty=4, shapes=_merge([shapes], [(0, True, False)], 'background'))
+
+    return layer
@@ -1,7 +1,13 @@
+import copy
 import math
+import types
+import cairo
+import numpy as np
 from colour import Color
 from abc import ABC, abstractmethod
-from mathanim.utils import Vector2, convert_colour, convert_vector2
+from mathanim import geometry, gradients, layout, raster
+from mathanim.errors import ArgumentError
+from mathanim.utils import Bounds, Vector2, convert_colour, convert_vector2, values_equal
 
 class SceneObject(ABC):
     '''
@@ -9,6 +15,15 @@ class SceneObject(ABC):
 
     '''
 
+    # The names of attributes holding render caches (e.g. cairo surfaces) that cannot be copied.
+    # These are reset to ``None`` whenever the object is copied (e.g. when it is added to a frame).
+    _transient_attributes = ()
+
+    # Indicates whether drawing the object updates its state (e.g. an object that accumulates
+    # previous frames). Stateful objects are drawn exactly once per frame, in order, so they
+    # disable renderers that draw an object more than once per frame (e.g. tiled rendering).
+    stateful = False
+
     def __init__(self, position=None, rotation=0, scale=None, opacity=1):
         '''
         Initializes an instance of :class:`SceneObject`.
@@ -66,6 +81,56 @@ class SceneObject(ABC):
 
         self.__scale = Vector2(1, 1) if value is None else convert_vector2(value)
 
+    @property
+    def bounds(self):
+        '''
+        Gets the bounding box of this object in the scene's reference frame.
+
+        :note:
+            This is used to skip objects that are outside of the camera's view. Objects whose
+            extent is unknown return ``None`` and are always drawn.
+
+        :returns:
+            A :class:`mathanim.utils.Bounds` object, or ``None``.
+
+        '''
+
+        return None
+
+    def _scene_bounds(self, points, padding=0):
+        '''
+        Gets the bounding box of points given in this object's local space, where the local space
+        is scaled, rotated and then translated by the object's transformation.
+
+        :param points:
+            A numpy array of points with shape ``(n, 2)``.
+        :param padding:
+            An amount, in local units, to grow the box by (e.g. half of a stroke width).
+        :returns:
+            A :class:`mathanim.utils.Bounds` object, or ``None`` if there are no finite points.
+
+        '''
+
+        c, s = math.cos(self.rotation), math.sin(self.rotation)
+        scale = np.array([self.scale.x, self.scale.y])
+        points = (points * scale) @ np.array([[c, s], [-s, c]]) + (self.position.x, self.position.y)
+
+        bounds = Bounds.from_points(points)
+        if bounds is None or padding == 0: return bounds
+        return bounds.expand(padding * float(np.abs(scale).max()))
+
+    def __getstate__(self):
+        '''
+        Gets the state of this object for copying, excluding any transient attributes.
+
+        '''
+
+        state = self.__dict__.copy()
+        for name in self._transient_attributes:
+            state[name] = None
+
+        return state
+
     @abstractmethod
     def draw(self, render_context):
         '''
@@ -79,6 +144,36 @@ class SceneObject(ABC):
         # Implemented in subclasses
         pass
 
+    def prepare(self, matrix, width, height):
+        '''
+        Builds the render caches of this object for a frame before it is drawn.
+
+        :note:
+            Renderers that draw a frame in parallel tiles call this once per frame, so that an object
+            whose caches depend on its transformation builds them once (rather than in every tile,
+            from several threads at once). Drawing still works if this is not called.
+
+        :param matrix:
+            The :class:`cairo.Matrix` from the space that the object is positioned in to device space.
+        :param width:
+            The width of the frame, in pixels.
+        :param height:
+            The height of the frame, in pixels.
+
+        '''
+
+        pass
+
+    def _local_matrix(self):
+        '''
+        Gets the transformation of this object (scaled, rotated and then translated) as a :class:`cairo.Matrix`.
+
+        '''
+
+        c, s = math.cos(self.rotation), math.sin(self.rotation)
+        return cairo.Matrix(c * self.scale.x, s * self.scale.x, -s * self.scale.y, c * self.scale.y,
+                            self.position.x, self.position.y)
+
 class Shape(SceneObject):
     '''
     The base class for all primitive shape objects.
@@ -100,6 +195,7 @@ class Shape(SceneObject):
             The scale of the shape. Defaults to the unit vector.
         :param fill_colour:
             The fill colour of the shape. Defaults to white.
+            This can also be a :class:`mathanim.gradients.Gradient` given in the shape's local space.
             If set to ``None``, the shape has no fill.
         :param fill_opacity:
             The opacity of the shape fill. Defaults to 1 (fully opaque).
@@ -125,7 +221,7 @@ class Shape(SceneObject):
         super().__init__(position, rotation, scale, opacity)
 
         self.size = Vector2()
-        self.fill_colour = convert_colour(fill_colour)
+        self.fill_colour = fill_colour
         self.fill_opacity = fill_opacity
         self.border_radius = border_radius
         self.stroke_colour = convert_colour(stroke_colour)
@@ -189,7 +285,7 @@ class Shape(SceneObject):
     @property
     def fill_colour(self):
         '''
-        The fill colour of the shape.
+        The fill colour (or :class:`mathanim.gradients.Gradient`) of the shape.
 
         '''
 
@@ -202,7 +298,7 @@ class Shape(SceneObject):
 
         '''
 
-        self.__fill_colour = convert_colour(value)
+        self.__fill_colour = value if isinstance(value, gradients.Gradient) else convert_colour(value)
 
     @property
     def stroke_colour(self):
@@ -222,6 +318,26 @@ class Shape(SceneObject):
 
         self.__stroke_colour = convert_colour(value)
 
+    def _fill_and_stroke(self, render_context):
+        '''
+        Fills and strokes the current path of the specified :class:`cairo.Context`
+        using the fill and stroke settings of this shape.
+
+        '''
+
+        do_stroke = self.stroke_colour is not None
+        if self.fill_colour is not None:
+            # the fill command consumes the current path so if we 
+            # want to draw a stroke AND a fill, we need to preserve it.
+            gradients.fill(render_context, self.fill_colour, self.opacity * self.fill_opacity, preserve=do_stroke)
+        
+        if do_stroke:
+            render_context.set_source_rgba(*self.stroke_colour.rgb, self.opacity * self.stroke_opacity)
+            render_context.set_line_width(self.stroke_width)
+            render_context.stroke()
+        else:
+            render_context.new_path()
+
 class Rectangle(Shape):
     '''
     A rectangle shape.
@@ -273,12 +389,20 @@ class Rectangle(Shape):
                         
         self.size = Vector2(width, height)
 
-    def draw(self, render_context):
+    @property
+    def bounds(self):
         '''
-        Draw this rectangle onto the specified :class:`cairo.Context`.
+        Gets the bounding box of this rectangle in the scene's reference frame.
 
-        :param:
-            A :class:`cairo.Context` that this object will be rendered onto.
+        '''
+
+        corners = np.array([(0, 0), (self.width, 0), (self.width, self.height), (0, self.height)], dtype=np.float64)
+        corners -= (self.width / 2, self.height / 2)
+        return self._scene_bounds(corners, self.stroke_width if self.stroke_colour is not None else 0)
+
+    def _transform(self, render_context):
+        '''
+        Transforms the specified :class:`cairo.Context` so that the rectangle spans from (0, 0) to its size.
 
         '''
 
@@ -293,6 +417,17 @@ class Rectangle(Shape):
         render_context.translate(-half_size.x, -half_size.y)
         render_context.scale(self.scale.x, self.scale.y)
 
+    def draw(self, render_context):
+        '''
+        Draw this rectangle onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        self._transform(render_context)
+
         # Draw the rectangle. We use the coordinate (0, 0) since the transformation matrix
         # has already been set to the position of the rectangle.
         render_context.new_sub_path()
@@ -302,18 +437,2503 @@ class Rectangle(Shape):
         render_context.arc(self.border_radius, self.border_radius, self.border_radius, math.radians(180), math.radians(270))
         render_context.close_path()
 
-        do_stroke = self.stroke_colour is not None
-        if self.fill_colour is not None:
-            render_context.set_source_rgba(*self.fill_colour.rgb, self.opacity * self.fill_opacity)
+        self._fill_and_stroke(render_context)
 
-            if do_stroke:
-                # the fill command consumes the current path so if we 
-                # want to draw a stroke AND a fill, we need to preserve it.
-                render_context.fill_preserve()
-            else:
-                render_context.fill()
-        
-        if do_stroke:
-            render_context.set_source_rgba(*self.stroke_colour.rgb, self.opacity * self.stroke_opacity)
-            render_context.set_line_width(self.stroke_width)
-            render_context.stroke()
+class Path(Shape):
+    '''
+    A polyline shape whose vertices are stored in a numpy array.
+
+    :note:
+        Paths are simplified in device space before they are drawn so that the cost of
+        drawing a path scales with its on-screen detail rather than its vertex count.
+
+    '''
+
+    def __init__(self, vertices=None, closed=False, position=None, rotation=0, scale=None,
+                 fill_colour=None, fill_opacity=1, stroke_colour='white', stroke_width=1,
+                 stroke_opacity=1, opacity=1, simplify_tolerance=0.5, percent_drawn=1):
+        '''
+        Initializes an instance of :class:`Path`.
+
+        :param vertices:
+            The vertices of the path given as an array-like object of points with shape ``(n, 2)``.
+            The vertices are relative to the position of the path. Defaults to an empty path.
+        :param closed:
+            Indicates whether the last vertex should be joined to the first. Defaults to ``False``.
+        :param position:
+            The position of the origin of the path given as coordiantes in the scene's 
+            reference frame. Defaults to the zero vector (top-left corner of the screen).
+        :param rotation:
+            The rotation of the path (about its origin), in radians. Defaults to 0.
+        :param scale:
+            The scale of the path. Defaults to the unit vector.
+        :param fill_colour:
+            The fill colour of the path. Defaults to ``None``, meaning that the path has no fill.
+        :param fill_opacity:
+            The opacity of the path fill. Defaults to 1 (fully opaque).
+        :param stroke_colour:
+            The colour of the path's stroke. Defaults to white.
+            If set to ``None``, the path has no stroke.
+        :param stroke_width:
+            The width of the stroke. Defaults to 1.
+        :param stroke_opacity:
+            The opacity of the stroke. Defaults to 1 (fully opaque).
+        :param opacity:
+            The opacity of the path. Defaults to 1 (fully opaque).
+        :param simplify_tolerance:
+            The maximum deviation, in output pixels, allowed when simplifying the path for drawing.
+            A value of 0 disables simplification. Defaults to half a pixel.
+        :param percent_drawn:
+            The fraction of the path's arc length that is drawn, from 0 to 1. Animating this
+            produces a "write-on" effect. Defaults to 1 (the whole path is drawn).
+
+        '''
+
+        super().__init__(position, rotation, scale, fill_colour, fill_opacity, 0, 
+                         stroke_colour, stroke_width, stroke_opacity, opacity)
+
+        self.closed = closed
+        self.vertices = vertices
+        self.simplify_tolerance = simplify_tolerance
+        self.percent_drawn = percent_drawn
+
+    @property
+    def vertices(self):
+        '''
+        Gets the vertices of the path as a numpy array with shape ``(n, 2)``.
+
+        '''
+
+        return self.__vertices
+
+    @vertices.setter
+    def vertices(self, value):
+        '''
+        Sets the vertices of the path.
+
+        '''
+
+        self.__vertices = geometry.as_points(value)
+        self.__arc_lengths = None
+
+        finite = self.__vertices[np.isfinite(self.__vertices).all(axis=1)]
+        if len(finite) == 0:
+            self.size = Vector2()
+        else:
+            extents = finite.max(axis=0) - finite.min(axis=0)
+            self.size = Vector2(float(extents[0]), float(extents[1]))
+
+    @property
+    def outline(self):
+        '''
+        Gets the vertices traced by the path's stroke (i.e. the vertices of a closed
+        path with the first vertex repeated at the end).
+
+        '''
+
+        if not self.closed or len(self.vertices) < 2: return self.vertices
+        return np.concatenate((self.vertices, self.vertices[:1]))
+
+    @property
+    def arc_lengths(self):
+        '''
+        Gets the cumulative arc length of the path's outline at each vertex.
+
+        :note:
+            This lookup table is computed once and cached until the vertices change.
+
+        '''
+
+        if self.__arc_lengths is None or len(self.__arc_lengths) != len(self.outline):
+            self.__arc_lengths = geometry.cumulative_lengths(self.outline)
+
+        return self.__arc_lengths
+
+    @property
+    def length(self):
+        '''
+        Gets the arc length of the path (in the path's local space).
+
+        '''
+
+        lengths = self.arc_lengths
+        return lengths[-1] if len(lengths) > 0 else 0
+
+    def point_at(self, percent):
+        '''
+        Gets the point at the specified fraction of the path's arc length.
+
+        :param percent:
+            The fraction of the arc length, from 0 to 1.
+        :returns:
+            A :class:`mathanim.utils.Vector2` containing the point in the path's local space.
+
+        '''
+
+        outline = self.outline
+        if len(outline) == 0: return Vector2()
+        if len(outline) == 1: return Vector2(*outline[0].tolist())
+
+        _, point = geometry.point_at_length(outline, self.arc_lengths, percent * self.length)
+        return Vector2(*point.tolist())
+
+    @property
+    def bounds(self):
+        '''
+        Gets the bounding box of this path in the scene's reference frame.
+
+        '''
+
+        return self._scene_bounds(self.vertices, self.stroke_width / 2 if self.stroke_colour is not None else 0)
+
+    def draw(self, render_context):
+        '''
+        Draw this path onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        self._apply_transform(render_context)
+        self._draw_vertices(render_context)
+
+    def _apply_transform(self, render_context):
+        '''
+        Applies the transformation of this path to the specified :class:`cairo.Context`.
+
+        '''
+
+        render_context.translate(self.position.x, self.position.y)
+        render_context.rotate(self.rotation)
+        render_context.scale(self.scale.x, self.scale.y)
+
+    def _draw_vertices(self, render_context):
+        '''
+        Simplifies, fills and strokes the vertices of this path in the current user space.
+
+        '''
+
+        vertices, closed = self.vertices, self.closed
+        if len(vertices) < 2 or self.percent_drawn <= 0: return
+
+        if self.percent_drawn < 1:
+            # Cut the outline at the drawn arc length; the lookup table makes this a binary search.
+            vertices, closed = self.outline, False
+            index, end = geometry.point_at_length(vertices, self.arc_lengths, self.percent_drawn * self.length)
+            vertices = np.concatenate((vertices[:index], end[None]))
+
+        # Simplify in device space so that the tolerance is measured in output pixels.
+        device_vertices = geometry.to_device(vertices, render_context.get_matrix())
+        indices = geometry.simplify(device_vertices, self.simplify_tolerance)
+
+        geometry.append_polyline(render_context, vertices[indices], closed)
+        self._fill_and_stroke(render_context)
+
+class FunctionGraph(Path):
+    '''
+    The graph of a function, ``y = f(x)``, sampled adaptively in screen space.
+
+    :note:
+        Samples are cached and only recomputed when the domain, the function parameters, or
+        the scale/rotation of the graph on screen change. When they do change, the existing
+        samples are reused as far as possible: samples inside a new domain are kept, and a
+        change in parameters re-evaluates the function at the existing sample positions
+        before refining them. Reused samples that are no longer needed (e.g. after zooming
+        out) are removed, so the number of samples does not only grow over an animation.
+
+        When a frame is drawn in parallel tiles, the samples are updated once by :meth:`prepare`,
+        so the tiles only read them.
+
+    '''
+
+    def __init__(self, func, domain=(0, 1), params=None, position=None, rotation=0, scale=None,
+                 stroke_colour='white', stroke_width=1, stroke_opacity=1, opacity=1,
+                 initial_samples=64, tolerance=0.25, max_depth=10, simplify_tolerance=0.5,
+                 percent_drawn=1):
+        '''
+        Initializes an instance of :class:`FunctionGraph`.
+
+        :param func:
+            The function to graph. It is called as ``func(x, **params)`` and should accept
+            a numpy array of x-coordinates. Scalar functions are vectorized automatically.
+        :param domain:
+            A tuple containing the minimum and maximum x-coordinate of the graph. Defaults to (0, 1).
+        :param params:
+            A dictionary of named parameters passed to the function. The parameters can be
+            animated by binding to ``params.<name>``. Defaults to no parameters.
+        :param position:
+            The position of the origin of the graph given as coordiantes in the scene's
+            reference frame. Defaults to the zero vector (top-left corner of the screen).
+        :param rotation:
+            The rotation of the graph (about its origin), in radians. Defaults to 0.
+        :param scale:
+            The scale of the graph (i.e. the size of a unit along each axis). Defaults to the unit vector.
+        :param stroke_colour:
+            The colour of the graph's stroke. Defaults to white.
+        :param stroke_width:
+            The width of the stroke. Defaults to 1.
+        :param stroke_opacity:
+            The opacity of the stroke. Defaults to 1 (fully opaque).
+        :param opacity:
+            The opacity of the graph. Defaults to 1 (fully opaque).
+        :param initial_samples:
+            The number of uniformly spaced samples taken before adaptive refinement. Defaults to 64.
+        :param tolerance:
+            The maximum deviation, in output pixels, between the sampled polyline and the
+            function before an interval is subdivided. Defaults to a quarter of a pixel.
+        :param max_depth:
+            The maximum number of times an initial interval can be subdivided. Defaults to 10.
+        :param simplify_tolerance:
+            The maximum deviation, in output pixels, allowed when simplifying the samples for drawing.
+            Defaults to half a pixel.
+        :param percent_drawn:
+            The fraction of the graph's arc length that is drawn, from 0 to 1. Defaults to 1.
+
+        '''
+
+        super().__init__(None, False, position, rotation, scale, None, 1, stroke_colour,
+                         stroke_width, stroke_opacity, opacity, simplify_tolerance, percent_drawn)
+
+        self.func = func
+        self.domain = domain
+        self.params = types.SimpleNamespace(**(params or {}))
+        self.initial_samples = initial_samples
+        self.tolerance = tolerance
+        self.max_depth = max_depth
+
+        self._sample_key = None
+        self._update_samples(np.identity(2))
+
+    @property
+    def domain(self):
+        '''
+        Gets the domain of the graph as a tuple containing the minimum and maximum x-coordinate.
+
+        '''
+
+        return self.__domain
+
+    @domain.setter
+    def domain(self, value):
+        '''
+        Sets the domain of the graph.
+
+        '''
+
+        x_min, x_max = value
+        self.__domain = (float(x_min), float(x_max))
+
+    @property
+    def bounds(self):
+        '''
+        Gets the bounding box of this graph in the scene's reference frame.
+
+        :note:
+            The graph is only resampled when it is drawn, so if the domain or parameters
+            changed since then, the extent is unknown and ``None`` is returned.
+
+        '''
+
+        previous = self._sample_key
+        if previous is None or previous[0] != self.domain or not _params_equal(previous[1], self._params_key()): return None
+        return super().bounds
+
+    def draw(self, render_context):
+        '''
+        Draw this graph onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        self._apply_transform(render_context)
+
+        # Sampling density only depends on the linear part of the transformation,
+        # so translating the graph (or the whole frame) never invalidates the samples.
+        linear, _ = geometry.matrix_to_array(render_context.get_matrix())
+        self._update_samples(linear)
+        self._draw_vertices(render_context)
+
+    def prepare(self, matrix, width, height):
+        '''
+        Resamples the graph for a frame before it is drawn (see :meth:`SceneObject.prepare`).
+
+        '''
+
+        linear, _ = geometry.matrix_to_array(self._local_matrix().multiply(matrix))
+        self._update_samples(linear)
+
+    def _evaluate(self, x):
+        '''
+        Evaluates the function at the specified x-coordinates.
+
+        '''
+
+        params = vars(self.params)
+        # Poles and other singularities are expected when graphing, so don't warn about them.
+        with np.errstate(all='ignore'):
+            try:
+                y = np.asarray(self.func(x, **params), dtype=np.float64)
+            except (TypeError, ValueError):
+                y = None
+
+            if y is None or y.shape != x.shape:
+                y = np.vectorize(lambda v: self.func(v, **params), otypes=[np.float64])(x)
+
+        # Infinities are treated as discontinuities (breaks in the polyline).
+        y[~np.isfinite(y)] = np.nan
+        return y
+
+    def _params_key(self):
+        '''
+        Gets the parameters of the function as a sorted tuple of ``(name, value)`` pairs, copying
+        the values so that the key is not changed by later in-place modifications.
+
+        '''
+
+        return tuple((name, copy.copy(value)) for name, value in sorted(vars(self.params).items()))
+
+    def _update_samples(self, linear):
+        '''
+        Resamples the function if the domain, parameters or on-screen transformation changed.
+
+        :param linear:
+            The 2x2 linear part of the user to device transformation.
+
+        '''
+
+        params = self._params_key()
+        settings = (self.initial_samples, self.tolerance, self.max_depth)
+        key = (self.domain, params, tuple(linear.ravel()), settings)
+
+        # The transformation is compared with a tolerance since it may be computed in different
+        # ways (e.g. by cairo when drawing and by prepare).
+        previous = self._sample_key
+        params_changed = previous is None or not _params_equal(previous[1], params)
+        if not params_changed and previous[0] == key[0] and previous[3] == key[3] and _close(previous[2], key[2]): return
+
+        x_min, x_max = self.domain
+        n_initial = max(self.initial_samples, 2)
+        spacing = max(x_max - x_min, np.finfo(np.float64).tiny) / (n_initial - 1)
+
+        if previous is not None and previous[3] == settings and len(self.vertices) > 0:
+            # Reuse the existing sample positions that lie inside the new domain.
+            x, y = self.vertices[:, 0], self.vertices[:, 1]
+            inside = (x >= x_min) & (x <= x_max)
+            x, y = x[inside], y[inside]
+            if params_changed:
+                y = self._evaluate(x)
+
+            # Uniformly sample any part of the domain that wasn't covered before.
+            old_min, old_max = previous[0]
+            new_x = [np.array([x_min, x_max])]
+            if x_min < old_min:
+                b = min(old_min, x_max)
+                new_x.append(np.linspace(x_min, b, max(int((b - x_min) / spacing) + 1, 2)))
+
+            if x_max > old_max:
+                a = max(old_max, x_min)
+                new_x.append(np.linspace(a, x_max, max(int((x_max - a) / spacing) + 1, 2)))
+
+            new_x = np.setdiff1d(np.concatenate(new_x), x)
+            x = np.concatenate((x, new_x))
+            y = np.concatenate((y, self._evaluate(new_x)))
+
+            order = np.argsort(x, kind='stable')
+            x, y = self._coarsen(x[order], y[order], linear, spacing)
+        else:
+            x = np.linspace(x_min, x_max, n_initial)
+            y = self._evaluate(x)
+
+        x, y = self._refine(x, y, linear, spacing)
+        self.vertices = np.column_stack((x, y))
+        self._sample_key = key
+
+    def _refine(self, x, y, linear, initial_spacing):
+        '''
+        Adaptively subdivides the sampled intervals until the polyline is within tolerance.
+
+        :param x:
+            The sorted x-coordinates of the samples.
+        :param y:
+            The function values at the samples.
+        :param linear:
+            The 2x2 linear part of the user to device transformation.
+        :param initial_spacing:
+            The spacing of the initial uniform samples (used to limit the subdivision depth).
+        :returns:
+            A tuple containing the refined x-coordinates and function values.
+
+        '''
+
+        min_spacing = initial_spacing / 2**self.max_depth
+        for _ in range(self.max_depth):
+            if len(x) < 3: break
+
+            deviation = _chord_deviation(x, y, linear)
+
+            # Subdivide both intervals adjacent to a sample that deviates too far from its chord
+            # and any interval that straddles a discontinuity.
+            bent = deviation > self.tolerance
+            finite = np.isfinite(y)
+            split = finite[:-1] != finite[1:]
+            split[:-1] |= bent
+            split[1:] |= bent
+            split &= np.diff(x) > min_spacing
+
+            indices = np.flatnonzero(split)
+            if len(indices) == 0: break
+
+            midpoints = (x[indices] + x[indices + 1]) / 2
+            x = np.insert(x, indices + 1, midpoints)
+            y = np.insert(y, indices + 1, self._evaluate(midpoints))
+
+        return x, y
+
+    def _coarsen(self, x, y, linear, max_spacing):
+        '''
+        Removes the samples that are no longer needed to keep the polyline within tolerance.
+
+        :note:
+            A sample is removed if it deviates from the chord joining its neighbours by less than half
+            of the tolerance (so that refining does not add it straight back) and the interval left
+            behind is no wider than the initial spacing. Samples next to a discontinuity are kept.
+
+        :param x:
+            The sorted x-coordinates of the samples.
+        :param y:
+            The function values at the samples.
+        :param linear:
+            The 2x2 linear part of the user to device transformation.
+        :param max_spacing:
+            The spacing of the initial uniform samples.
+        :returns:
+            A tuple containing the remaining x-coordinates and function values.
+
+        '''
+
+        for _ in range(self.max_depth):
+            if len(x) < 3: break
+
+            finite = np.isfinite(y)
+            removable = (_chord_deviation(x, y, linear) < self.tolerance / 2) & \
+                        finite[:-2] & finite[1:-1] & finite[2:] & (x[2:] - x[:-2] <= max_spacing)
+
+            # Neighbouring samples cannot both be removed, so every other sample of each run is removed.
+            positions = np.arange(len(removable))
+            run_starts = np.maximum.accumulate(np.where(removable & ~np.concatenate(([False], removable[:-1])), positions, 0))
+            indices = np.flatnonzero(removable & ((positions - run_starts) % 2 == 0)) + 1
+            if len(indices) == 0: break
+
+            x, y = np.delete(x, indices), np.delete(y, indices)
+
+        return x, y
+
+def _chord_deviation(x, y, linear):
+    '''
+    Gets the perpendicular distance (in device pixels) of each interior sample of a polyline from
+    the chord joining its neighbours.
+
+    '''
+
+    points = np.column_stack((x, y)) @ linear
+    a, b, c = points[:-2], points[1:-1], points[2:]
+
+    chord = c - a
+    offset = b - a
+    length = np.hypot(chord[:, 0], chord[:, 1])
+    with np.errstate(invalid='ignore', divide='ignore'):
+        deviation = np.abs(offset[:, 0] * chord[:, 1] - offset[:, 1] * chord[:, 0]) / length
+        return np.where(length > 0, deviation, np.hypot(offset[:, 0], offset[:, 1]))
+
+def _close(a, b):
+    '''
+    Determines whether two sequences of floats computed from the same transformation are equal
+    up to rounding error.
+
+    '''
+
+    return len(a) == len(b) and np.allclose(a, b, rtol=1e-9, atol=1e-9)
+
+def _params_equal(a, b):
+    '''
+    Determines whether two sorted tuples of ``(name, value)`` parameter pairs are equal.
+
+    '''
+
+    return len(a) == len(b) and all(name_a == name_b and values_equal(value_a, value_b)
+                                    for (name_a, value_a), (name_b, value_b) in zip(a, b))
+
+class Trail(SceneObject):
+    '''
+    A trail left behind by a moving point (e.g. the bob of a pendulum).
+
+    :note:
+        Rather than storing and redrawing the whole trajectory, a trail rasterizes the newest
+        segment onto a persistent surface (in device space) every frame and composites that surface
+        onto the frame. Fading is a single alpha multiplication of the persistent surface per frame.
+        As a result, the cost of drawing a trail does not grow with its length.
+
+        Since the trail is rasterized in device space, changing the transformation of the trail
+        only affects new segments.
+
+    '''
+
+    _transient_attributes = ('_surface', '_last_point')
+    stateful = True
+
+    def __init__(self, head=None, position=None, rotation=0, scale=None, stroke_colour='white',
+                 stroke_width=2, stroke_opacity=1, fade=1, opacity=1):
+        '''
+        Initializes an instance of :class:`Trail`.
+
+        :param head:
+            The current position of the point leaving the trail, relative to the position of
+            the trail. Animate this attribute to extend the trail. Defaults to the zero vector.
+        :param position:
+            The position of the origin of the trail given as coordiantes in the scene's 
+            reference frame. Defaults to the zero vector (top-left corner of the screen).
+        :param rotation:
+            The rotation of the trail (about its origin), in radians. Defaults to 0.
+        :param scale:
+            The scale of the trail. Defaults to the unit vector.
+        :param stroke_colour:
+            The colour of the trail. Defaults to white.
+        :param stroke_width:
+            The width of the trail. Defaults to 2.
+        :param stroke_opacity:
+            The opacity of newly drawn segments. Defaults to 1 (fully opaque).
+        :param fade:
+            The factor that the opacity of the existing trail is multiplied by every frame.
+            Defaults to 1 (the trail never fades).
+        :param opacity:
+            The opacity of the trail. Defaults to 1 (fully opaque).
+
+        '''
+
+        super().__init__(position, rotation, scale, opacity)
+
+        self.head = head
+        self.stroke_colour = stroke_colour
+        self.stroke_width = stroke_width
+        self.stroke_opacity = stroke_opacity
+        self.fade = fade
+
+        self._surface = None
+        self._last_point = None
+
+    @property
+    def head(self):
+        '''
+        Gets the current position of the point leaving the trail.
+
+        '''
+
+        return self.__head
+
+    @head.setter
+    def head(self, value):
+        '''
+        Sets the current position of the point leaving the trail.
+
+        '''
+
+        self.__head = Vector2() if value is None else convert_vector2(value)
+
+    @property
+    def stroke_colour(self):
+        '''
+        The colour of the trail.
+
+        '''
+
+        return self.__stroke_colour
+    
+    @stroke_colour.setter
+    def stroke_colour(self, value):
+        '''
+        Sets the colour of the trail.
+
+        '''
+
+        self.__stroke_colour = convert_colour(value, keep_none=False)
+
+    def clear(self):
+        '''
+        Erases the trail.
+
+        '''
+
+        self._surface = None
+        self._last_point = None
+
+    def draw(self, render_context):
+        '''
+        Draw this trail onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        render_context.translate(self.position.x, self.position.y)
+        render_context.rotate(self.rotation)
+        render_context.scale(self.scale.x, self.scale.y)
+        matrix = render_context.get_matrix()
+
+        target = render_context.get_target()
+        width, height = target.get_width(), target.get_height()
+        if self._surface is None or (self._surface.get_width(), self._surface.get_height()) != (width, height):
+            self._surface = cairo.ImageSurface(cairo.FORMAT_ARGB32, width, height)
+            self._last_point = None
+
+        trail_context = cairo.Context(self._surface)
+        if self.fade < 1:
+            # Multiply the alpha (and, since the surface is premultiplied, the colour) of every pixel.
+            trail_context.set_operator(cairo.OPERATOR_DEST_IN)
+            trail_context.set_source_rgba(0, 0, 0, max(self.fade, 0))
+            trail_context.paint()
+            trail_context.set_operator(cairo.OPERATOR_OVER)
+
+        point = matrix.transform_point(self.head.x, self.head.y)
+        if self._last_point is not None and self._last_point != point:
+            # Draw the new segment in user space so that the stroke width is transformed.
+            inverse = cairo.Matrix(*matrix)
+            inverse.invert()
+
+            trail_context.set_matrix(matrix)
+            trail_context.move_to(*inverse.transform_point(*self._last_point))
+            trail_context.line_to(self.head.x, self.head.y)
+            trail_context.set_source_rgba(*self.stroke_colour.rgb, self.stroke_opacity)
+            trail_context.set_line_width(self.stroke_width)
+            trail_context.set_line_cap(cairo.LINE_CAP_ROUND)
+            trail_context.stroke()
+
+        self._last_point = point
+
+        render_context.identity_matrix()
+        render_context.set_source_surface(self._surface, 0, 0)
+        render_context.paint_with_alpha(self.opacity)
+
+class ParticleSystem(SceneObject):
+    '''
+    A system of particles emitted from a point and advanced by vectorized update rules.
+
+    :note:
+        The state of every particle (position, velocity, colour, size, age) is stored in
+        preallocated numpy arrays. Particles are spawned into the slots of dead particles, so
+        emitting particles never allocates Python objects, and all particles are splatted into a
+        pixel buffer that is composited onto the frame in a single draw call.
+
+        The system is simulated up to its ``time`` attribute (in seconds) using fixed time steps.
+        Animate ``time`` (e.g. with a :class:`mathanim.actions.Ramp` from 0 to the duration) to
+        advance the system. Since the emitter is seeded, simulations are reproducible.
+
+        By default, particles are spawned in the space of the system's parent: the transform of the
+        emitter (its position, rotation and scale) is baked into each particle when it is emitted,
+        so moving the emitter leaves the live particles behind. The transform is sampled when the
+        system is drawn, i.e. once per frame for all of the time steps simulated in that frame.
+        With ``local_space=True``, particles are stored relative to the emitter instead, and move
+        (and rotate) with it.
+
+    '''
+
+    # The simulation is advanced when the system is drawn.
+    stateful = True
+
+    def __init__(self, capacity=10000, emission_rate=1000, lifetime=2, position=None, rotation=0, 
+                 scale=None, emitter_radius=0, velocity=None, velocity_spread=50, acceleration=None, 
+                 drag=0, size=2, colours='white', fade_out=True, update_func=None, time_step=1/60,
+                 seed=0, local_space=False, opacity=1):
+        '''
+        Initializes an instance of :class:`ParticleSystem`.
+
+        :param capacity:
+            The maximum number of live particles. Defaults to 10000.
+        :param emission_rate:
+            The number of particles emitted per second. Defaults to 1000.
+        :param lifetime:
+            The lifetime of a particle, in seconds. Defaults to 2.
+        :param position:
+            The position of the emitter given as coordiantes in the scene's reference frame.
+            Defaults to the zero vector (top-left corner of the screen).
+        :param rotation:
+            The rotation of the system (about the emitter), in radians. Defaults to 0.
+        :param scale:
+            The scale of the system. Defaults to the unit vector.
+        :param emitter_radius:
+            The radius of the disc that particles are emitted from. Defaults to 0 (a point emitter).
+        :param velocity:
+            The mean initial velocity of a particle, in units per second, relative to the emitter
+            (i.e. it is rotated and scaled with the system). Defaults to the zero vector.
+        :param velocity_spread:
+            The standard deviation of the initial velocity of a particle. Defaults to 50.
+        :param acceleration:
+            A constant acceleration (e.g. gravity) applied to every particle, in the space that the
+            particles are stored in (see ``local_space``). Defaults to the zero vector.
+        :param drag:
+            The fraction of velocity lost per second. Defaults to 0.
+        :param size:
+            The diameter of a particle. Defaults to 2.
+        :param colours:
+            A colour, or list of colours, that particles are randomly assigned. Defaults to white.
+        :param fade_out:
+            Indicates whether particles should fade out over their lifetime. Defaults to ``True``.
+        :param update_func:
+            An optional function, ``update_func(system, dt)``, called every time step after the
+            built-in update rules. It should update the particle arrays of the system in-place.
+        :param time_step:
+            The time step of the simulation, in seconds. Defaults to 1/60.
+        :param seed:
+            The seed of the random number generator used by the emitter. Defaults to 0.
+        :param local_space:
+            Indicates whether particles are stored relative to the emitter, so that they follow it
+            when it moves. Defaults to ``False``, meaning that particles are stored in the space of
+            the system's parent and stay where they were emitted.
+        :param opacity:
+            The opacity of the system. Defaults to 1 (fully opaque).
+
+        '''
+
+        super().__init__(position, rotation, scale, opacity)
+
+        self.local_space = local_space
+        self.emission_rate = emission_rate
+        self.lifetime = lifetime
+        self.emitter_radius = emitter_radius
+        self.velocity = velocity
+        self.velocity_spread = velocity_spread
+        self.acceleration = acceleration
+        self.drag = drag
+        self.size = size
+        self.fade_out = fade_out
+        self.update_func = update_func
+        self.time_step = time_step
+        self.seed = seed
+        self.time = 0
+
+        if isinstance(colours, (str, Color)): colours = [colours]
+        self.colours = [convert_colour(colour) for colour in colours]
+
+        self.positions = np.zeros((capacity, 2), dtype=np.float64)
+        self.velocities = np.zeros((capacity, 2), dtype=np.float64)
+        self.colour_values = np.zeros((capacity, 4), dtype=np.float32)
+        self.sizes = np.zeros(capacity, dtype=np.float64)
+        self.ages = np.zeros(capacity, dtype=np.float64)
+        self.alive = np.zeros(capacity, dtype=bool)
+        self.reset()
+
+    @property
+    def velocity(self):
+        '''
+        Gets the mean initial velocity of a particle.
+
+        '''
+
+        return self.__velocity
+
+    @velocity.setter
+    def velocity(self, value):
+        '''
+        Sets the mean initial velocity of a particle.
+
+        '''
+
+        self.__velocity = Vector2() if value is None else convert_vector2(value)
+
+    @property
+    def acceleration(self):
+        '''
+        Gets the constant acceleration applied to every particle.
+
+        '''
+
+        return self.__acceleration
+
+    @acceleration.setter
+    def acceleration(self, value):
+        '''
+        Sets the constant acceleration applied to every particle.
+
+        '''
+
+        self.__acceleration = Vector2() if value is None else convert_vector2(value)
+
+    @property
+    def capacity(self):
+        '''
+        Gets the maximum number of live particles.
+
+        '''
+
+        return len(self.alive)
+
+    @property
+    def count(self):
+        '''
+        Gets the number of live particles.
+
+        '''
+
+        return int(np.count_nonzero(self.alive))
+
+    def reset(self):
+        '''
+        Kills every particle and rewinds the simulation to time zero.
+
+        '''
+
+        self.alive[:] = False
+        self._rng = np.random.default_rng(self.seed)
+        self._simulated_time = 0
+        self._pending_emissions = 0
+
+    def emit(self, count):
+        '''
+        Spawns particles into the slots of dead particles.
+
+        :param count:
+            The number of particles to spawn. This is limited by the number of free slots.
+
+        '''
+
+        slots = np.flatnonzero(~self.alive)[:count]
+        n = len(slots)
+        if n == 0: return
+
+        rng = self._rng
+        angle = rng.uniform(0, 2 * math.pi, n)
+        radius = self.emitter_radius * np.sqrt(rng.uniform(0, 1, n))
+        positions = np.column_stack((radius * np.cos(angle), radius * np.sin(angle)))
+        velocities = rng.normal((self.velocity.x, self.velocity.y), self.velocity_spread, (n, 2))
+        size = self.size
+        if not self.local_space:
+            linear, translation = geometry.matrix_to_array(self._local_matrix())
+            positions = positions @ linear + translation
+            velocities = velocities @ linear
+            size *= math.sqrt(abs(np.linalg.det(linear)))
+
+        self.positions[slots] = positions
+        self.velocities[slots] = velocities
+        palette = np.array([(*colour.rgb, 1) for colour in self.colours], dtype=np.float32)
+        self.colour_values[slots] = palette[rng.integers(0, len(palette), n)]
+        self.sizes[slots] = size
+        self.ages[slots] = 0
+        self.alive[slots] = True
+
+    def step(self, dt):
+        '''
+        Advances the simulation by a single time step.
+
+        :param dt:
+            The length of the time step, in seconds.
+
+        '''
+
+        self._pending_emissions += self.emission_rate * dt
+        count = int(self._pending_emissions)
+        self._pending_emissions -= count
+        self.emit(count)
+
+        alive = self.alive
+        self.velocities[alive] += (self.acceleration.x * dt, self.acceleration.y * dt)
+        if self.drag > 0:
+            self.velocities[alive] *= max(1 - self.drag * dt, 0)
+
+        self.positions[alive] += self.velocities[alive] * dt
+        self.ages[alive] += dt
+        if self.update_func is not None:
+            self.update_func(self, dt)
+
+        alive &= self.ages < self.lifetime
+
+    def simulate(self, time):
+        '''
+        Advances the simulation up to the specified time.
+
+        :note:
+            Simulating to an earlier time restarts the simulation from time zero.
+
+        :param time:
+            The time, in seconds, to simulate up to.
+
+        '''
+
+        if time < self._simulated_time:
+            self.reset()
+
+        while self._simulated_time + self.time_step <= time + 1e-9:
+            self.step(self.time_step)
+            self._simulated_time += self.time_step
+
+    def draw(self, render_context):
+        '''
+        Draw this particle system onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        self.simulate(self.time)
+        if not self.alive.any(): return
+
+        if self.local_space:
+            render_context.translate(self.position.x, self.position.y)
+            render_context.rotate(self.rotation)
+            render_context.scale(self.scale.x, self.scale.y)
+
+        matrix = render_context.get_matrix()
+        linear, _ = geometry.matrix_to_array(matrix)
+        pixel_scale = math.sqrt(abs(np.linalg.det(linear)))
+
+        alive = self.alive
+        colours = self.colour_values[alive]
+        if self.fade_out:
+            colours = colours.copy()
+            colours[:, 3] *= np.clip(1 - self.ages[alive] / self.lifetime, 0, 1)
+
+        target = render_context.get_target()
+        result = raster.splat(geometry.to_device(self.positions[alive], matrix), self.sizes[alive] * pixel_scale / 2,
+                              colours, target.get_width(), target.get_height())
+        if result is None: return
+
+        (x, y), pixels = result
+        render_context.identity_matrix()
+        render_context.set_source_surface(raster.surface_from_array(pixels), x, y)
+        render_context.paint_with_alpha(self.opacity)
+
+class VectorField(SceneObject):
+    '''
+    A grid of arrows visualizing a vector field.
+
+    :note:
+        The field function is evaluated once per frame over the whole grid and the geometry of
+        every arrow is built with vectorized operations. Arrows are bucketed by colour and each
+        bucket is drawn with a single stroke, so the number of cairo draw calls does not depend
+        on the number of arrows.
+
+    '''
+
+    def __init__(self, func, x_range=(0, 1), y_range=(0, 1), spacing=0.1, position=None, rotation=0,
+                 scale=None, length_scale=1, max_length=None, head_size=None, colours='white', 
+                 magnitude_range=None, stroke_width=1, opacity=1):
+        '''
+        Initializes an instance of :class:`VectorField`.
+
+        :param func:
+            The field function. It is called as ``func(x, y, time)`` with numpy arrays of grid
+            coordinates and should return a tuple containing the x and y components of the field.
+        :param x_range:
+            A tuple containing the minimum and maximum x-coordinate of the grid. Defaults to (0, 1).
+        :param y_range:
+            A tuple containing the minimum and maximum y-coordinate of the grid. Defaults to (0, 1).
+        :param spacing:
+            The distance between neighbouring grid points. Defaults to 0.1.
+        :param position:
+            The position of the origin of the field given as coordiantes in the scene's 
+            reference frame. Defaults to the zero vector (top-left corner of the screen).
+        :param rotation:
+            The rotation of the field (about its origin), in radians. Defaults to 0.
+        :param scale:
+            The scale of the field. Defaults to the unit vector.
+        :param length_scale:
+            The factor that the magnitude of the field is multiplied by to get the length of an arrow.
+            Defaults to 1.
+        :param max_length:
+            The maximum length of an arrow. Defaults to the grid spacing.
+        :param head_size:
+            The length of an arrow head. Defaults to a quarter of the grid spacing.
+        :param colours:
+            A colour, or list of colours, used to colour the arrows. If multiple colours are given,
+            arrows are coloured by magnitude along the gradient formed by the colours.
+            Defaults to white.
+        :param magnitude_range:
+            A tuple containing the magnitudes mapped to the first and last colour. Defaults to the
+            range of magnitudes in the current frame.
+        :param stroke_width:
+            The width of the arrows. Defaults to 1.
+        :param opacity:
+            The opacity of the field. Defaults to 1 (fully opaque).
+
+        '''
+
+        super().__init__(position, rotation, scale, opacity)
+
+        self.func = func
+        self.x_range = x_range
+        self.y_range = y_range
+        self.spacing = spacing
+        self.length_scale = length_scale
+        self.max_length = max_length
+        self.head_size = head_size
+        self.magnitude_range = magnitude_range
+        self.stroke_width = stroke_width
+        self.time = 0
+
+        if isinstance(colours, (str, Color)): colours = [colours]
+        self.colours = [convert_colour(colour) for colour in colours]
+
+        self._grid_key = None
+        self._grid = None
+
+    @property
+    def grid(self):
+        '''
+        Gets the grid points of the field as a tuple containing a numpy array of x-coordinates
+        and a numpy array of y-coordinates.
+
+        :note:
+            The grid is cached until the ranges or spacing change.
+
+        '''
+
+        key = (tuple(self.x_range), tuple(self.y_range), self.spacing)
+        if key != self._grid_key:
+            x = np.arange(self.x_range[0], self.x_range[1] + self.spacing / 2, self.spacing)
+            y = np.arange(self.y_range[0], self.y_range[1] + self.spacing / 2, self.spacing)
+            x, y = np.meshgrid(x, y)
+            self._grid = (x.ravel(), y.ravel())
+            self._grid_key = key
+
+        return self._grid
+
+    @property
+    def bounds(self):
+        '''
+        Gets the bounding box of this field in the scene's reference frame.
+
+        '''
+
+        corners = np.array([(self.x_range[0], self.y_range[0]), (self.x_range[1], self.y_range[1])], dtype=np.float64)
+        max_length = self.max_length if self.max_length is not None else self.spacing
+        return self._scene_bounds(corners, max_length + self.stroke_width)
+
+    def arrows(self):
+        '''
+        Builds the geometry of the arrows at the current time.
+
+        :returns:
+            A tuple containing a numpy array of arrow polylines with shape ``(n, 6, 2)`` (the shaft
+            followed by a break and the head) and a numpy array of the field magnitudes at each arrow.
+
+        '''
+
+        x, y = self.grid
+        u, v = self.func(x, y, self.time)
+        vectors = np.column_stack((np.broadcast_to(u, x.shape), np.broadcast_to(v, y.shape))).astype(np.float64)
+        magnitudes = np.hypot(vectors[:, 0], vectors[:, 1])
+
+        max_length = self.spacing if self.max_length is None else self.max_length
+        head_size = self.spacing / 4 if self.head_size is None else self.head_size
+        with np.errstate(invalid='ignore', divide='ignore'):
+            directions = np.where(magnitudes[:, None] > 0, vectors / magnitudes[:, None], 0)
+
+        lengths = np.minimum(magnitudes * self.length_scale, max_length)[:, None]
+        centres = np.column_stack((x, y))
+        tails = centres - directions * lengths / 2
+        tips = centres + directions * lengths / 2
+
+        # The barbs of the head are the reversed direction rotated by +/- 30 degrees.
+        heads = np.minimum(head_size, lengths)
+        cos, sin = math.cos(math.pi / 6), math.sin(math.pi / 6)
+        back = -directions * heads
+        left = np.column_stack((back[:, 0] * cos - back[:, 1] * sin, back[:, 0] * sin + back[:, 1] * cos))
+        right = np.column_stack((back[:, 0] * cos + back[:, 1] * sin, -back[:, 0] * sin + back[:, 1] * cos))
+
+        breaks = np.full_like(tails, np.nan)
+        polylines = np.stack((tails, tips, breaks, tips + left, tips, tips + right), axis=1)
+        return polylines, magnitudes
+
+    def draw(self, render_context):
+        '''
+        Draw this vector field onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        render_context.translate(self.position.x, self.position.y)
+        render_context.rotate(self.rotation)
+        render_context.scale(self.scale.x, self.scale.y)
+
+        polylines, magnitudes = self.arrows()
+        visible = magnitudes > 0
+        if not visible.any(): return
+
+        polylines, magnitudes = polylines[visible], magnitudes[visible]
+        if len(self.colours) == 1:
+            buckets = np.zeros(len(magnitudes), dtype=np.int64)
+            palette = [self.colours[0].rgb]
+        else:
+            low, high = self.magnitude_range or (magnitudes.min(), magnitudes.max())
+            t = np.clip((magnitudes - low) / (high - low), 0, 1) if high > low else np.zeros_like(magnitudes)
+
+            # Quantize the gradient so that arrows can be drawn in a handful of batches.
+            n_buckets = 16 * (len(self.colours) - 1)
+            buckets = np.minimum((t * n_buckets).astype(np.int64), n_buckets - 1)
+            stops = np.linspace(0, 1, len(self.colours))
+            samples = (np.arange(n_buckets) + 0.5) / n_buckets
+            rgb = np.array([colour.rgb for colour in self.colours])
+            palette = np.column_stack([np.interp(samples, stops, rgb[:, i]) for i in range(3)]).tolist()
+
+        render_context.set_line_width(self.stroke_width)
+        render_context.set_line_cap(cairo.LINE_CAP_ROUND)
+        render_context.set_line_join(cairo.LINE_JOIN_ROUND)
+
+        separator = np.full((len(polylines), 1, 2), np.nan)
+        polylines = np.concatenate((polylines, separator), axis=1)
+        for bucket in np.unique(buckets).tolist():
+            geometry.append_polyline(render_context, polylines[buckets == bucket].reshape(-1, 2))
+            render_context.set_source_rgba(*palette[bucket], self.opacity)
+            render_context.stroke()
+
+class Mesh(SceneObject):
+    '''
+    A three-dimensional polygon mesh projected onto the scene.
+
+    :note:
+        The mesh is expressed in a camera space whose x-axis points right, y-axis points down and
+        z-axis points into the screen. Every frame, all vertices are rotated and projected with a
+        single matrix multiplication, back faces are culled and the remaining faces are sorted
+        back to front (painter's algorithm) with a single argsort. Consecutive faces that share a
+        colour are filled with one draw call.
+
+        Front faces are those whose vertices appear clockwise on screen.
+
+    '''
+
+    def __init__(self, vertices, faces, position=None, rotation=0, scale=None, rotation_x=0, rotation_y=0,
+                 camera_distance=None, fill_colour='white', face_colours=None, stroke_colour=None, 
+                 stroke_width=1, light_direction=(-1, -1, 1), ambient=0.3, cull_back_faces=True,
+                 shade_levels=64, opacity=1):
+        '''
+        Initializes an instance of :class:`Mesh`.
+
+        :param vertices:
+            An array-like object of vertices with shape ``(v, 3)``.
+        :param faces:
+            An array-like object of vertex indices with shape ``(f, k)``; each row is a face with k vertices.
+        :param position:
+            The position of the origin of the mesh given as coordiantes in the scene's 
+            reference frame. Defaults to the zero vector (top-left corner of the screen).
+        :param rotation:
+            The rotation of the mesh about the z-axis (i.e. in the plane of the screen), in radians.
+            Defaults to 0.
+        :param scale:
+            The scale of the projected mesh (i.e. the size of a unit on screen). Defaults to the unit vector.
+        :param rotation_x:
+            The rotation of the mesh about the x-axis, in radians. Defaults to 0.
+        :param rotation_y:
+            The rotation of the mesh about the y-axis, in radians. Defaults to 0.
+        :param camera_distance:
+            The distance from the camera to the origin of the mesh, in mesh units. 
+            Defaults to ``None``, meaning that an orthographic projection is used.
+        :param fill_colour:
+            The fill colour of the faces. Defaults to white. If set to ``None``, faces are not filled.
+        :param face_colours:
+            An optional array-like object of RGB colours (from 0 to 1) with shape ``(f, 3)``
+            overriding the fill colour of each face.
+        :param stroke_colour:
+            The colour of the edges. Defaults to ``None``, meaning that edges are not drawn.
+        :param stroke_width:
+            The width of the edges. Defaults to 1.
+        :param light_direction:
+            The direction that light travels in camera space. Defaults to (-1, -1, 1).
+        :param ambient:
+            The fraction of the fill colour visible on faces that aren't lit. Defaults to 0.3.
+        :param cull_back_faces:
+            Indicates whether back faces should be culled. Defaults to ``True``.
+        :param shade_levels:
+            The number of distinct shades per colour channel. Fewer levels allow more faces to be
+            drawn with a single call. Defaults to 64.
+        :param opacity:
+            The opacity of the mesh. Defaults to 1 (fully opaque).
+
+        '''
+
+        super().__init__(position, rotation, scale, opacity)
+
+        self.vertices = np.asarray(vertices, dtype=np.float64).reshape(-1, 3)
+        self.faces = np.asarray(faces, dtype=np.int64)
+        self.rotation_x = rotation_x
+        self.rotation_y = rotation_y
+        self.camera_distance = camera_distance
+        self.fill_colour = fill_colour
+        self.face_colours = None if face_colours is None else np.asarray(face_colours, dtype=np.float64)
+        self.stroke_colour = stroke_colour
+        self.stroke_width = stroke_width
+        self.light_direction = light_direction
+        self.ambient = ambient
+        self.cull_back_faces = cull_back_faces
+        self.shade_levels = shade_levels
+
+    @classmethod
+    def cube(cls, size=1, **kwargs):
+        '''
+        Creates a cube centred at the origin.
+
+        :param size:
+            The length of an edge of the cube. Defaults to 1.
+        :param **kwargs:
+            Additional keyword arguments passed to the :class:`Mesh` constructor.
+
+        '''
+
+        h = size / 2
+        vertices = [(x, y, z) for x in (-h, h) for y in (-h, h) for z in (-h, h)]
+        faces = [(0, 4, 6, 2), (1, 3, 7, 5), (0, 1, 5, 4), (2, 6, 7, 3), (0, 2, 3, 1), (4, 5, 7, 6)]
+        return cls(vertices, faces, **kwargs)
+
+    @property
+    def fill_colour(self):
+        '''
+        The fill colour of the faces.
+
+        '''
+
+        return self.__fill_colour
+    
+    @fill_colour.setter
+    def fill_colour(self, value):
+        '''
+        Sets the fill colour of the faces.
+
+        '''
+
+        self.__fill_colour = convert_colour(value)
+
+    @property
+    def stroke_colour(self):
+        '''
+        The colour of the edges.
+
+        '''
+
+        return self.__stroke_colour
+    
+    @stroke_colour.setter
+    def stroke_colour(self, value):
+        '''
+        Sets the colour of the edges.
+
+        '''
+
+        self.__stroke_colour = convert_colour(value)
+
+    def project(self):
+        '''
+        Transforms and projects the vertices of the mesh.
+
+        :returns:
+            A tuple containing a numpy array of the projected vertices with shape ``(v, 2)``
+            and a numpy array of the vertices in camera space with shape ``(v, 3)``.
+
+        '''
+
+        camera = self.vertices @ geometry.rotation_matrix(self.rotation_x, self.rotation_y).T
+        if self.camera_distance is None:
+            return camera[:, :2], camera
+
+        with np.errstate(divide='ignore', invalid='ignore'):
+            depth = camera[:, 2] + self.camera_distance
+            projected = camera[:, :2] * (self.camera_distance / np.where(depth > 0, depth, np.nan))[:, None]
+
+        return projected, camera
+
+    def draw(self, render_context):
+        '''
+        Draw this mesh onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        if len(self.faces) == 0 or (self.fill_colour is None and self.stroke_colour is None): return
+
+        render_context.translate(self.position.x, self.position.y)
+        render_context.rotate(self.rotation)
+        render_context.scale(self.scale.x, self.scale.y)
+
+        projected, camera = self.project()
+        polygons = projected[self.faces]
+        corners = camera[self.faces]
+
+        # Twice the signed area of each projected face (positive when clockwise on screen).
+        x, y = polygons[..., 0], polygons[..., 1]
+        areas = (x * np.roll(y, -1, axis=1) - np.roll(x, -1, axis=1) * y).sum(axis=1)
+
+        visible = np.isfinite(areas) & (areas != 0)
+        if self.cull_back_faces:
+            visible &= areas > 0
+
+        faces = np.flatnonzero(visible)
+        if len(faces) == 0: return
+
+        # Painter's algorithm: draw the farthest faces first.
+        depths = corners[faces, :, 2].mean(axis=1)
+        faces = faces[np.argsort(-depths, kind='stable')]
+        polygons, corners = polygons[faces], corners[faces]
+
+        # Runs of faces are filled as one path with the nonzero winding rule, so back faces are
+        # reversed to wind like front faces; otherwise overlapping faces would cancel each other out.
+        back = areas[faces] < 0
+        polygons[back] = polygons[back, ::-1]
+
+        if self.fill_colour is not None:
+            normals = np.cross(corners[:, 1] - corners[:, 0], corners[:, 2] - corners[:, 0])
+            normals /= np.maximum(np.linalg.norm(normals, axis=1), 1e-12)[:, None]
+            light = -np.asarray(self.light_direction, dtype=np.float64)
+            light /= max(np.linalg.norm(light), 1e-12)
+
+            shade = self.ambient + (1 - self.ambient) * np.abs(normals @ light)
+            base = self.face_colours[faces] if self.face_colours is not None else np.array(self.fill_colour.rgb)
+            colours = np.round(base * shade[:, None] * (self.shade_levels - 1)).astype(np.int64)
+        else:
+            colours = np.zeros((len(faces), 3), dtype=np.int64)
+
+        # Split the sorted faces into runs of the same colour; each run is drawn with one call.
+        # A translucent mesh draws every face on its own so that overlapping faces blend in depth order.
+        codes = (colours[:, 0] * self.shade_levels + colours[:, 1]) * self.shade_levels + colours[:, 2]
+        if self.opacity >= 1:
+            starts = np.flatnonzero(np.concatenate(([True], codes[1:] != codes[:-1])))
+        else:
+            starts = np.arange(len(faces))
+
+        ends = np.append(starts[1:], len(faces))
+
+        polygons = polygons.tolist()
+        palette = (colours[starts] / (self.shade_levels - 1)).tolist()
+
+        render_context.set_line_width(self.stroke_width)
+        render_context.set_line_join(cairo.LINE_JOIN_ROUND)
+        for rgb, start, end in zip(palette, starts.tolist(), ends.tolist()):
+            geometry.append_polygons(render_context, polygons[start:end])
+            if self.fill_colour is not None:
+                render_context.set_source_rgba(*rgb, self.opacity)
+                if self.stroke_colour is None:
+                    render_context.fill()
+                    continue
+
+                render_context.fill_preserve()
+
+            render_context.set_source_rgba(*self.stroke_colour.rgb, self.opacity)
+            render_context.stroke()
+
+class Surface(Mesh):
+    '''
+    The surface of a function of two variables, ``height = f(x, z)``, as a mesh.
+
+    :note:
+        The domain of the function lies in the xz-plane of the camera space and the
+        height of the surface points up the screen (i.e. along the negative y-axis).
+
+    '''
+
+    def __init__(self, func, x_range=(-1, 1), z_range=(-1, 1), resolution=(32, 32), **kwargs):
+        '''
+        Initializes an instance of :class:`Surface`.
+
+        :param func:
+            The function to plot. It is called as ``func(x, z)`` with numpy arrays of coordinates.
+        :param x_range:
+            A tuple containing the minimum and maximum x-coordinate of the domain. Defaults to (-1, 1).
+        :param z_range:
+            A tuple containing the minimum and maximum z-coordinate of the domain. Defaults to (-1, 1).
+        :param resolution:
+            A tuple containing the number of faces along the x and z axes. Defaults to (32, 32).
+        :param **kwargs:
+            Additional keyword arguments passed to the :class:`Mesh` constructor.
+            Back-face culling is disabled by default since surfaces are double-sided.
+
+        '''
+
+        nx, nz = resolution
+        x, z = np.meshgrid(np.linspace(*x_range, nx + 1), np.linspace(*z_range, nz + 1))
+        height = np.broadcast_to(np.asarray(func(x, z), dtype=np.float64), x.shape)
+        vertices = np.column_stack((x.ravel(), -height.ravel(), z.ravel()))
+
+        # Each cell of the grid becomes a quad.
+        index = np.arange((nx + 1) * (nz + 1)).reshape(nz + 1, nx + 1)
+        faces = np.stack((index[:-1, :-1], index[:-1, 1:], index[1:, 1:], index[1:, :-1]), axis=-1).reshape(-1, 4)
+
+        kwargs.setdefault('cull_back_faces', False)
+        super().__init__(vertices, faces, **kwargs)
+
+class NetworkGraph(SceneObject):
+    '''
+    A network of nodes joined by edges, arranged with a force-directed layout.
+
+    :note:
+        The layout is computed once, when the graph is created, and every iteration of it is
+        stored. The ``progress`` attribute selects (and interpolates between) the stored iterations,
+        so the convergence of the layout can be animated without recomputing anything.
+
+    '''
+
+    def __init__(self, node_count, edges, position=None, rotation=0, scale=None, layout_iterations=300,
+                 seed=0, initial_positions=None, progress=1, node_radius=4, node_colour='white', 
+                 edge_colour='grey', edge_width=1, edge_opacity=1, opacity=1):
+        '''
+        Initializes an instance of :class:`NetworkGraph`.
+
+        :param node_count:
+            The number of nodes in the graph.
+        :param edges:
+            An array-like object of node index pairs with shape ``(m, 2)``.
+        :param position:
+            The position of the centre of the graph given as coordiantes in the scene's 
+            reference frame. Defaults to the zero vector (top-left corner of the screen).
+        :param rotation:
+            The rotation of the graph (about its centre), in radians. Defaults to 0.
+        :param scale:
+            The scale of the graph. The final layout fits in a square with sides of one unit, so
+            this is the size of the graph. Defaults to the unit vector.
+        :param layout_iterations:
+            The number of iterations of the force-directed layout. Defaults to 300.
+        :param seed:
+            The seed of the random initial layout. Defaults to 0.
+        :param initial_positions:
+            An optional array-like object of initial node positions with shape ``(node_count, 2)``.
+        :param progress:
+            The fraction of the layout iterations to show, from 0 (the initial layout) to 1 (the
+            final layout). Defaults to 1.
+        :param node_radius:
+            The radius of a node. Defaults to 4.
+        :param node_colour:
+            The colour of the nodes. Defaults to white. If set to ``None``, nodes are not drawn.
+        :param edge_colour:
+            The colour of the edges. Defaults to grey. If set to ``None``, edges are not drawn.
+        :param edge_width:
+            The width of the edges. Defaults to 1.
+        :param edge_opacity:
+            The opacity of the edges. Defaults to 1 (fully opaque).
+        :param opacity:
+            The opacity of the graph. Defaults to 1 (fully opaque).
+
+        '''
+
+        super().__init__(position, rotation, scale, opacity)
+
+        self.edges = np.asarray(edges, dtype=np.int64).reshape(-1, 2)
+        self.layout = layout.force_directed(node_count, self.edges, layout_iterations, seed, initial_positions)
+
+        # Fit the final iteration of the layout in a unit square centred at the origin
+        # (the earlier iterations are transformed the same way so that the graph settles in place).
+        final = self.layout[-1]
+        centre = (final.min(axis=0) + final.max(axis=0)) / 2
+        extent = float((final.max(axis=0) - final.min(axis=0)).max()) if len(final) > 1 else 0
+        self.layout -= centre
+        self.layout /= extent or 1
+
+        self.progress = progress
+        self.node_radius = node_radius
+        self.node_colour = convert_colour(node_colour)
+        self.edge_colour = convert_colour(edge_colour)
+        self.edge_width = edge_width
+        self.edge_opacity = edge_opacity
+
+    @property
+    def node_count(self):
+        '''
+        Gets the number of nodes in the graph.
+
+        '''
+
+        return self.layout.shape[1]
+
+    @property
+    def node_positions(self):
+        '''
+        Gets the positions of the nodes at the current progress of the layout.
+
+        :returns:
+            A numpy array with shape ``(node_count, 2)``.
+
+        '''
+
+        step = min(max(self.progress, 0), 1) * (len(self.layout) - 1)
+        index = min(int(step), len(self.layout) - 2) if len(self.layout) > 1 else 0
+        t = step - index
+        if t == 0 or len(self.layout) == 1:
+            return self.layout[index].astype(np.float64)
+
+        return self.layout[index] * (1 - t) + self.layout[index + 1] * t
+
+    @property
+    def bounds(self):
+        '''
+        Gets the bounding box of this graph in the scene's reference frame.
+
+        '''
+
+        bounds = self._scene_bounds(self.node_positions)
+        if bounds is None: return None
+        return bounds.expand(max(self.node_radius, self.edge_width / 2))
+
+    def draw(self, render_context):
+        '''
+        Draw this graph onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        render_context.translate(self.position.x, self.position.y)
+        render_context.rotate(self.rotation)
+        render_context.scale(self.scale.x, self.scale.y)
+
+        # Draw sizes are given in scene units, so undo the scale of the layout for them.
+        unit = math.sqrt(abs(self.scale.x * self.scale.y)) or 1
+        positions = self.node_positions
+
+        if self.edge_colour is not None and len(self.edges) > 0:
+            segments = np.full((len(self.edges), 3, 2), np.nan)
+            segments[:, 0] = positions[self.edges[:, 0]]
+            segments[:, 1] = positions[self.edges[:, 1]]
+
+            geometry.append_polyline(render_context, segments.reshape(-1, 2))
+            render_context.set_source_rgba(*self.edge_colour.rgb, self.opacity * self.edge_opacity)
+            render_context.set_line_width(self.edge_width / unit)
+            render_context.stroke()
+
+        if self.node_colour is not None and self.node_radius > 0:
+            radius = self.node_radius / unit
+            new_sub_path, arc = render_context.new_sub_path, render_context.arc
+            for x, y in positions.tolist():
+                new_sub_path()
+                arc(x, y, radius, 0, 2 * math.pi)
+
+            render_context.set_source_rgba(*self.node_colour.rgb, self.opacity)
+            render_context.fill()
+
+class BarChartRace(SceneObject):
+    '''
+    A horizontal bar chart whose bars are ranked by value and slide into place as the ranking changes.
+
+    :note:
+        Ranks are updated incrementally whenever ``values`` is assigned: the entities are re-sorted
+        starting from their previous order using a stable (Timsort-based) sort, which runs in
+        near-linear time when only a few ranks change between frames. Bar positions ease towards
+        their ranks with a single vectorized update and only the bars within the top ``top_k``
+        ranks are drawn.
+
+        Bind a :class:`mathanim.actions.DataTrack` producing one value per entity to ``values``.
+        Bars only ease while the ``time`` attribute (in seconds) advances, so animate it as well
+        (e.g. with a :class:`mathanim.actions.Ramp` from 0 to the duration of the track). The easing
+        is scaled by the time elapsed between draws, so it does not depend on the frame rate or on
+        which frames are drawn. While ``time`` does not advance (e.g. if it is not animated), bars
+        are drawn at their ranks.
+
+    '''
+
+    # Bars ease towards their ranks each time the chart is drawn.
+    stateful = True
+
+    def __init__(self, labels, values=None, top_k=10, position=None, rotation=0, scale=None, bar_length=800,
+                 bar_height=40, bar_spacing=10, colours=None, text_colour='white', font_size=None,
+                 font_family='sans-serif', value_format='{:,.0f}', rank_smoothing=0.25, time=0, opacity=1):
+        '''
+        Initializes an instance of :class:`BarChartRace`.
+
+        :param labels:
+            The labels of the entities.
+        :param values:
+            An array-like object containing the value of each entity. Defaults to zeros.
+        :param top_k:
+            The number of bars that are shown. Defaults to 10.
+        :param position:
+            The position of the top-left corner of the chart given as coordiantes in the scene's 
+            reference frame. Defaults to the zero vector (top-left corner of the screen).
+        :param rotation:
+            The rotation of the chart (about its top-left corner), in radians. Defaults to 0.
+        :param scale:
+            The scale of the chart. Defaults to the unit vector.
+        :param bar_length:
+            The length of the bar with the largest value. Defaults to 800.
+        :param bar_height:
+            The height of a bar. Defaults to 40.
+        :param bar_spacing:
+            The space between neighbouring bars. Defaults to 10.
+        :param colours:
+            A list of colours assigned to the entities in turn. Defaults to a qualitative palette.
+        :param text_colour:
+            The colour of the labels and values. Defaults to white.
+        :param font_size:
+            The font size of the labels and values. Defaults to half of the bar height.
+        :param font_family:
+            The font family of the labels and values. Defaults to sans-serif.
+        :param value_format:
+            The format string used to display values. Defaults to '{:,.0f}'.
+        :param rank_smoothing:
+            The fraction of the distance to its rank that a bar moves every 1/60 of a second,
+            from 0 to 1. Defaults to 0.25.
+        :param time:
+            The time of the chart, in seconds, which drives the easing of the bars. Defaults to 0.
+        :param opacity:
+            The opacity of the chart. Defaults to 1 (fully opaque).
+
+        '''
+
+        super().__init__(position, rotation, scale, opacity)
+
+        self.labels = list(labels)
+        self._order = np.arange(len(self.labels))
+        self.values = values
+        self.top_k = top_k
+        self.bar_length = bar_length
+        self.bar_height = bar_height
+        self.bar_spacing = bar_spacing
+        self.text_colour = convert_colour(text_colour)
+        self.font_size = font_size
+        self.font_family = font_family
+        self.value_format = value_format
+        self.rank_smoothing = rank_smoothing
+        self.time = time
+
+        colours = colours or ['#4e79a7', '#f28e2b', '#e15759', '#76b7b2', '#59a14f',
+                              '#edc948', '#b07aa1', '#ff9da7', '#9c755f', '#bab0ac']
+        palette = np.array([convert_colour(colour).rgb for colour in colours])
+        self.colour_values = palette[np.arange(len(self.labels)) % len(palette)]
+
+        self._display_ranks = None
+        self._display_time = None
+
+    @property
+    def values(self):
+        '''
+        Gets the value of each entity as a numpy array.
+
+        '''
+
+        return self.__values
+
+    @values.setter
+    def values(self, value):
+        '''
+        Sets the value of each entity.
+
+        '''
+
+        self.__values = np.zeros(len(self.labels)) if value is None else np.asarray(value, dtype=np.float64)
+        self._update_order()
+
+    @property
+    def ranks(self):
+        '''
+        Gets the current rank of each entity (0 is the largest value).
+
+        :note:
+            The ranks are updated when ``values`` is assigned, not when it is modified in-place.
+
+        '''
+
+        ranks = np.empty(len(self._order), dtype=np.int64)
+        ranks[self._order] = np.arange(len(self._order))
+        return ranks
+
+    def _update_order(self):
+        '''
+        Re-sorts the entities by value, starting from their previous order.
+
+        '''
+
+        # Sorting the previous order (rather than the raw values) keeps the input nearly sorted,
+        # which a stable sort exploits, and keeps ties in their previous order.
+        values = np.nan_to_num(self.values, nan=-np.inf)
+        self._order = self._order[np.argsort(-values[self._order], kind='stable')]
+
+    def draw(self, render_context):
+        '''
+        Draw this chart onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        render_context.translate(self.position.x, self.position.y)
+        render_context.rotate(self.rotation)
+        render_context.scale(self.scale.x, self.scale.y)
+
+        ranks = self.ranks.astype(np.float64)
+        elapsed = 0 if self._display_time is None else self.time - self._display_time
+
+        # Bars snap to their ranks unless time has advanced since the previous draw.
+        if elapsed <= 0 or self._display_ranks is None or len(self._display_ranks) != len(ranks):
+            self._display_ranks = ranks
+        else:
+            smoothing = min(max(self.rank_smoothing, 0), 1)
+            self._display_ranks += (ranks - self._display_ranks) * (1 - (1 - smoothing) ** (elapsed * 60))
+
+        self._display_time = self.time
+
+        # Cull the bars that are (and will stay) outside of the visible ranks.
+        visible = np.flatnonzero(np.minimum(self._display_ranks, ranks) < self.top_k)
+        visible = visible[np.argsort(-self._display_ranks[visible])]
+        if len(visible) == 0: return
+
+        leader = self.values[self._order[0]]
+        lengths = np.clip(self.values[visible] / leader, 0, 1) * self.bar_length if leader > 0 else np.zeros(len(visible))
+        tops = self._display_ranks[visible] * (self.bar_height + self.bar_spacing)
+
+        # Bars that are sliding out of the top ranks fade out.
+        alphas = np.clip(self.top_k - self._display_ranks[visible], 0, 1) * self.opacity
+
+        render_context.select_font_face(self.font_family)
+        render_context.set_font_size(self.font_size or self.bar_height / 2)
+        ascent, descent = render_context.font_extents()[:2]
+        baseline = (self.bar_height + ascent - descent) / 2
+
+        for entity, length, top, alpha in zip(visible.tolist(), lengths.tolist(), tops.tolist(), alphas.tolist()):
+            render_context.rectangle(0, top, length, self.bar_height)
+            render_context.set_source_rgba(*self.colour_values[entity], alpha)
+            render_context.fill()
+
+            render_context.set_source_rgba(*self.text_colour.rgb, alpha)
+            label = str(self.labels[entity])
+            label_width = render_context.text_extents(label)[4]
+            render_context.move_to(-label_width - self.bar_spacing, top + baseline)
+            render_context.show_text(label)
+
+            render_context.move_to(length + self.bar_spacing, top + baseline)
+            render_context.show_text(self.value_format.format(self.values[entity]))
+
+class PointCloud(SceneObject):
+    '''
+    A large set of points drawn by aggregating them into screen-space bins.
+
+    :note:
+        Rather than drawing every point, the points are binned into a grid of device pixels
+        (counting the points, or averaging their values, in each bin) and the aggregate is
+        colour-mapped into a pixel buffer that is composited in a single draw call.
+
+        The aggregate covers the visible part of the frame plus a margin and is cached: as long as
+        only the translation of the cloud on screen changes (by whole bins, e.g. when panning) and
+        the visible part stays inside the aggregated region, the points are not binned again.
+        When a frame is drawn in parallel tiles, the points are binned once for the whole frame
+        by :meth:`prepare`, and each tile draws its part of that aggregate.
+
+    '''
+
+    _transient_attributes = ('_bins', '_buffers')
+
+    def __init__(self, points, values=None, position=None, rotation=0, scale=None, aggregate='count',
+                 colours=None, value_range=None, log_scale=True, bin_size=1, margin=0.125, opacity=1):
+        '''
+        Initializes an instance of :class:`PointCloud`.
+
+        :param points:
+            An array-like object of points with shape ``(n, 2)``.
+        :param values:
+            An optional array-like object with shape ``(n,)`` containing a value for each point.
+            Required if the aggregate is 'mean'.
+        :param position:
+            The position of the origin of the cloud given as coordiantes in the scene's 
+            reference frame. Defaults to the zero vector (top-left corner of the screen).
+        :param rotation:
+            The rotation of the cloud (about its origin), in radians. Defaults to 0.
+        :param scale:
+            The scale of the cloud. Defaults to the unit vector.
+        :param aggregate:
+            The aggregate computed for each bin: 'count' (the number of points in the bin) or
+            'mean' (the mean value of the points in the bin). Defaults to 'count'.
+        :param colours:
+            A list of colours forming the gradient that the aggregate is mapped onto.
+            Defaults to a perceptually uniform palette from dark blue to yellow.
+        :param value_range:
+            A tuple containing the aggregates mapped to the first and last colour. Defaults to the
+            range of the aggregate over the bins that contain points.
+        :param log_scale:
+            Indicates whether counts should be mapped to colours on a logarithmic scale.
+            This has no effect on means. Defaults to ``True``.
+        :param bin_size:
+            The size of a bin, in output pixels. Defaults to 1.
+        :param margin:
+            The size of the margin aggregated around the visible part of the frame, as a fraction
+            of the size of the frame. A larger margin lets the cloud pan further before the points are
+            binned again, at the cost of binning a larger region. Defaults to 0.125.
+        :param opacity:
+            The opacity of the cloud. Defaults to 1 (fully opaque).
+
+        '''
+
+        super().__init__(position, rotation, scale, opacity)
+
+        if aggregate not in ('count', 'mean'):
+            raise ArgumentError('Invalid aggregate \'{}\'. Expected \'count\' or \'mean\'.'.format(aggregate))
+
+        if aggregate == 'mean' and values is None:
+            raise ArgumentError('A PointCloud with a \'mean\' aggregate requires values.')
+
+        self.points = points
+        self.values = values
+        self.aggregate = aggregate
+        self.value_range = value_range
+        self.log_scale = log_scale
+        self.bin_size = bin_size
+        self.margin = margin
+
+        colours = colours or ['#440154', '#3b528b', '#21918c', '#5ec962', '#fde725']
+        self.colours = [convert_colour(colour) for colour in colours]
+
+        self._bins = None
+        self._buffers = None
+
+    @property
+    def points(self):
+        '''
+        Gets the points of this cloud as a numpy array with shape ``(n, 2)``.
+
+        '''
+
+        return self.__points
+
+    @points.setter
+    def points(self, value):
+        '''
+        Sets the points of this cloud.
+
+        '''
+
+        self.__points = geometry.as_points(value)
+        self.__extent = Bounds.from_points(self.__points)
+        self._bins = None
+
+    @property
+    def values(self):
+        '''
+        Gets the values of the points as a numpy array (or ``None``).
+
+        '''
+
+        return self.__values
+
+    @values.setter
+    def values(self, value):
+        '''
+        Sets the values of the points.
+
+        '''
+
+        self.__values = None if value is None else np.asarray(value, dtype=np.float64).ravel()
+        self._bins = None
+
+    @property
+    def bounds(self):
+        '''
+        Gets the bounding box of this cloud in the scene's reference frame.
+
+        '''
+
+        if self.__extent is None: return None
+        return self._scene_bounds(self.__extent.corners, 1)
+
+    def draw(self, render_context):
+        '''
+        Draw this point cloud onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        if len(self.points) == 0: return
+
+        render_context.translate(self.position.x, self.position.y)
+        render_context.rotate(self.rotation)
+        render_context.scale(self.scale.x, self.scale.y)
+
+        target = render_context.get_target()
+        bin_size = max(int(self.bin_size), 1)
+        region, pixels, offset = self._get_bins(render_context.get_matrix(), target.get_width(), target.get_height())
+        if pixels is None: return
+
+        render_context.identity_matrix()
+        render_context.scale(bin_size, bin_size)
+        render_context.set_source_surface(raster.surface_from_array(pixels), region[0] + offset[0], region[1] + offset[1])
+        render_context.get_source().set_filter(cairo.FILTER_NEAREST)
+        render_context.paint_with_alpha(self.opacity)
+
+    def prepare(self, matrix, width, height):
+        '''
+        Bins the points for a whole frame before it is drawn (see :meth:`SceneObject.prepare`).
+
+        '''
+
+        if len(self.points) == 0: return
+        self._get_bins(self._local_matrix().multiply(matrix), width, height)
+
+    def _get_bins(self, matrix, width, height):
+        '''
+        Gets the colour-mapped aggregate of the points, binning them only if the cached aggregate
+        cannot be reused.
+
+        :param matrix:
+            The :class:`cairo.Matrix` from the cloud's local space to device space.
+        :param width:
+            The width of the device surface, in pixels.
+        :param height:
+            The height of the device surface, in pixels.
+        :returns:
+            A tuple containing the aggregated region (in bins, relative to the whole-bin offset), the
+            pixels of the aggregate (or ``None`` if it is empty) and the whole-bin offset of the cloud.
+
+        '''
+
+        bin_size = max(int(self.bin_size), 1)
+        linear, translation = geometry.matrix_to_array(matrix)
+        linear, translation = linear / bin_size, translation / bin_size
+
+        # Split the translation into whole bins (applied when compositing) and a fractional
+        # part (applied when binning), so panning by whole bins reuses the cached aggregate.
+        offset = np.floor(translation)
+        fraction = translation - offset
+
+        width, height = -(-width // bin_size), -(-height // bin_size)
+        visible = (-int(offset[0]), -int(offset[1]), width - int(offset[0]), height - int(offset[1]))
+
+        transform = tuple(linear.ravel()) + tuple(fraction)
+        key = (self.aggregate, self.value_range, self.log_scale, tuple(colour.hex_l for colour in self.colours), bin_size)
+
+        # The cache is read into a local so that concurrent draws (e.g. of different tiles of a frame)
+        # always use a consistent aggregate. The transformation is compared with a tolerance since
+        # it may be computed in different ways (e.g. by cairo when drawing and by prepare).
+        bins = self._bins
+        if bins is None or bins[1] != key or not _close(bins[0], transform) or not _contains(bins[2], visible):
+            margin_x, margin_y = int(width * self.margin), int(height * self.margin)
+            region = (visible[0] - margin_x, visible[1] - margin_y, visible[2] + margin_x, visible[3] + margin_y)
+            bins = self._bins = (transform, key, region, self._aggregate(self.points @ linear + fraction, region))
+
+        return bins[2], bins[3], offset
+
+    def _aggregate(self, points, region):
+        '''
+        Bins the points and colour-maps the aggregate.
+
+        :param points:
+            A numpy array with shape ``(n, 2)`` containing the points in bin space.
+        :param region:
+            A tuple containing the bounds of the aggregated region, in bins.
+        :returns:
+            A numpy array of BGRA bytes with the shape of the region, or ``None`` if the region is empty.
+
+        '''
+
+        x_min, y_min, x_max, y_max = region
+        shape = (y_max - y_min, x_max - x_min)
+
+        # The count buffers are reused between binnings of the same size. They are taken out of the
+        # object while they are in use, so concurrent draws never share them.
+        buffers = self.__dict__.pop('_buffers', None)
+        if buffers is None or buffers[0].shape != shape or (self.aggregate == 'mean') != (buffers[1] is not None):
+            buffers = (np.empty(shape, dtype=np.int64), np.empty(shape, dtype=np.float64) if self.aggregate == 'mean' else None)
+
+        counts, sums = raster.bin_points(points, x_min, y_min, shape[1], shape[0],
+                                         self.values if self.aggregate == 'mean' else None, buffers)
+        self._buffers = buffers
+
+        occupied = counts > 0
+        if not occupied.any(): return None
+
+        if self.aggregate == 'mean':
+            aggregate = sums[occupied] / counts[occupied]
+        else:
+            aggregate = counts[occupied].astype(np.float64)
+            if self.log_scale: aggregate = np.log1p(aggregate)
+
+        if self.value_range is not None:
+            low, high = self.value_range
+            if self.aggregate == 'count' and self.log_scale: low, high = np.log1p(low), np.log1p(high)
+        else:
+            low, high = aggregate.min(), aggregate.max()
+
+        t = np.clip((aggregate - low) / (high - low), 0, 1) if high > low else np.ones_like(aggregate)
+
+        lut = raster.colour_lut(self.colours)
+        pixels = np.zeros(counts.shape + (4,), dtype=np.uint8)
+        pixels[occupied] = lut[(t * (len(lut) - 1) + 0.5).astype(np.int64)]
+        return pixels
+
+def _contains(outer, inner):
+    '''
+    Determines whether the rectangle ``inner`` lies inside the rectangle ``outer``.
+    Both rectangles are given as tuples of the form ``(x_min, y_min, x_max, y_max)``.
+
+    '''
+
+    return outer[0] <= inner[0] and outer[1] <= inner[1] and outer[2] >= inner[2] and outer[3] >= inner[3]
+
+class Camera(SceneObject):
+    '''
+    The viewpoint that a scene is rendered from.
+
+    :note:
+        A camera is animated like any other object (e.g. by binding sequences to its ``position``,
+        ``zoom`` or ``rotation``) but it is never drawn. Instead, it determines the transformation
+        from the scene to the frame, which is applied once before the objects are drawn.
+
+    '''
+
+    def __init__(self, position=None, zoom=1, rotation=0):
+        '''
+        Initializes an instance of :class:`Camera`.
+
+        :param position:
+            The point in the scene's reference frame that is shown at the centre of the frame.
+            Defaults to the zero vector (top-left corner of the screen).
+        :param zoom:
+            The magnification of the camera. Defaults to 1.
+        :param rotation:
+            The rotation of the camera, in radians. Positive rotations turn the view clockwise,
+            so the scene appears to rotate counter-clockwise. Defaults to 0.
+
+        '''
+
+        super().__init__(position, rotation)
+        self.zoom = zoom
+
+    def get_matrix(self, width, height):
+        '''
+        Gets the transformation from the scene to the frame.
+
+        :param width:
+            The width of the scene's reference frame.
+        :param height:
+            The height of the scene's reference frame.
+        :returns:
+            A :class:`cairo.Matrix` mapping the scene onto the reference frame.
+
+        '''
+
+        c, s = math.cos(self.rotation) * self.zoom, math.sin(self.rotation) * self.zoom
+        x, y = self.position.x, self.position.y
+        return cairo.Matrix(c, -s, s, c, width / 2 - (c * x + s * y), height / 2 - (c * y - s * x))
+
+    def view_bounds(self, width, height):
+        '''
+        Gets the bounding box of the part of the scene that is visible to this camera.
+
+        :param width:
+            The width of the scene's reference frame.
+        :param height:
+            The height of the scene's reference frame.
+        :returns:
+            A :class:`mathanim.utils.Bounds` object in the scene's reference frame.
+
+        '''
+
+        corners = (Bounds(0, 0, width, height).corners - (width / 2, height / 2)) / self.zoom
+        c, s = math.cos(self.rotation), math.sin(self.rotation)
+        return Bounds.from_points(corners @ np.array([[c, s], [-s, c]]) + (self.position.x, self.position.y))
+
+    def draw(self, render_context):
+        '''
+        Cameras are not drawn.
+
+        '''
+
+        pass
+
+class GroupChildren(list):
+    '''
+    The list of children of a :class:`Group`, whose items can also be accessed as attributes named
+    after their index so that they can be animated with "dot" notation (e.g. ``children.0.position``).
+
+    '''
+
+    def __getattr__(self, name):
+        '''
+        Gets the child at the index given by the attribute name.
+
+        '''
+
+        if name.isdigit() and int(name) < len(self):
+            return self[int(name)]
+
+        raise AttributeError('\'{}\' object has no attribute \'{}\''.format(type(self).__name__, name))
+
+    def __setattr__(self, name, value):
+        '''
+        Sets the child at the index given by the attribute name.
+
+        '''
+
+        if not name.isdigit():
+            super().__setattr__(name, value)
+        elif int(name) < len(self):
+            self[int(name)] = value
+        else:
+            raise AttributeError('Group has no child at index {}.'.format(name))
+
+class Group(SceneObject):
+    '''
+    A collection of objects that are transformed and faded together.
+
+    :note:
+        Fading a group correctly requires compositing its children offscreen (otherwise overlapping
+        children show through each other), which is expensive. The group decides every time it is
+        drawn whether this is needed: if it is opaque, or its children do not overlap, its opacity
+        is folded into the opacity of each child instead. Otherwise, the offscreen surface is
+        limited to the bounds of the group rather than the whole frame.
+
+        A group can be clipped by a mask object. An opaque rectangle without rounded corners or a
+        stroke is applied as a cairo clip. Any other mask is rasterized into an alpha-only surface
+        that is reused for as long as the mask and the transformation of the group are unchanged.
+
+        The children belong to the group: an object in a group must not also be added to the scene
+        on its own (it would be drawn twice). Children are animated through the group instead,
+        by index (e.g. ``Animation(group, {'children.0.position': ...})``).
+
+    '''
+
+    _transient_attributes = ('_mask_cache',)
+
+    def __init__(self, children=None, position=None, rotation=0, scale=None, opacity=1, clip_mask=None):
+        '''
+        Initializes an instance of :class:`Group`.
+
+        :param children:
+            A list of :class:`SceneObject` objects, in draw order. Their positions are given
+            relative to the group. Defaults to an empty list.
+        :param position:
+            The position of the group. Defaults to the zero vector, meaning that the positions
+            of the children are given in the scene's reference frame.
+        :param rotation:
+            The rotation of the group about its position, in radians. Defaults to 0.
+        :param scale:
+            The scale of the group. Defaults to the unit vector.
+        :param opacity:
+            The opacity of the group. Defaults to 1 (fully opaque).
+        :param clip_mask:
+            A :class:`SceneObject`, positioned relative to the group, whose coverage clips the group.
+            Defaults to ``None``, meaning that the group is not clipped.
+
+        '''
+
+        super().__init__(position, rotation, scale, opacity)
+        self.children = children
+        self.clip_mask = clip_mask
+        self._mask_cache = None
+
+    @property
+    def children(self):
+        '''
+        Gets the children of the group, in draw order, as a :class:`GroupChildren` list.
+
+        '''
+
+        return self.__children
+
+    @children.setter
+    def children(self, value):
+        '''
+        Sets the children of the group.
+
+        '''
+
+        self.__children = GroupChildren([] if value is None else value)
+
+    @property
+    def stateful(self):
+        '''
+        Gets whether drawing the group updates its state (i.e. whether any of its children are stateful).
+
+        '''
+
+        return any(child.stateful for child in self.children) or \
+               (self.clip_mask is not None and self.clip_mask.stateful)
+
+    @property
+    def bounds(self):
+        '''
+        Gets the bounding box of this group in the scene's reference frame.
+
+        '''
+
+        local_bounds = self._local_bounds()
+        mask_bounds = self.clip_mask.bounds if self.clip_mask is not None else None
+        if local_bounds is None:
+            local_bounds = mask_bounds
+        elif mask_bounds is not None:
+            x_min, y_min = max(local_bounds.x_min, mask_bounds.x_min), max(local_bounds.y_min, mask_bounds.y_min)
+            local_bounds = Bounds(x_min, y_min, max(x_min, min(local_bounds.x_max, mask_bounds.x_max)),
+                                  max(y_min, min(local_bounds.y_max, mask_bounds.y_max)))
+
+        if local_bounds is None: return None
+        return self._scene_bounds(local_bounds.corners)
+
+    def _local_bounds(self):
+        '''
+        Gets the bounding box of the children in the group's local space, or ``None`` if it is unknown.
+
+        '''
+
+        bounds = None
+        for child in self.children:
+            child_bounds = child.bounds
+            if child_bounds is None: return None
+            bounds = child_bounds if bounds is None else bounds.union(child_bounds)
+
+        return bounds
+
+    def draw(self, render_context):
+        '''
+        Draw this group onto the specified :class:`cairo.Context`.
+
+        :param:
+            A :class:`cairo.Context` that this object will be rendered onto.
+
+        '''
+
+        if self.opacity <= 0 or len(self.children) == 0: return
+
+        render_context.translate(self.position.x, self.position.y)
+        render_context.rotate(self.rotation)
+        render_context.scale(self.scale.x, self.scale.y)
+
+        if self.clip_mask is None:
+            self._composite(render_context)
+        elif _is_clip_rectangle(self.clip_mask):
+            render_context.save()
+            self.clip_mask._transform(render_context)
+            render_context.rectangle(0, 0, self.clip_mask.width, self.clip_mask.height)
+            render_context.restore()
+            render_context.clip()
+            self._composite(render_context)
+        else:
+            mask = self._get_mask(render_context)
+            if mask is None: return
+
+            surface, x, y = mask
+            render_context.save()
+            render_context.identity_matrix()
+            render_context.rectangle(x, y, surface.get_width(), surface.get_height())
+            render_context.restore()
+            render_context.clip()
+
+            render_context.push_group()
+            self._composite(render_context)
+            render_context.pop_group_to_source()
+            render_context.identity_matrix()
+            render_context.mask_surface(surface, x, y)
+
+    def prepare(self, matrix, width, height):
+        '''
+        Prepares the children of this group for a frame before it is drawn (see :meth:`SceneObject.prepare`).
+
+        '''
+
+        matrix = self._local_matrix().multiply(matrix)
+        for child in self.children:
+            child.prepare(matrix, width, height)
+
+    def _composite(self, render_context):
+        '''
+        Draws the children of this group with the opacity of the group applied.
+
+        '''
+
+        if self.opacity >= 1:
+            self._draw_children(render_context)
+            return
+
+        child_bounds = [child.bounds for child in self.children]
+        if not _overlapping(child_bounds):
+            self._draw_children(render_context, self.opacity)
+            return
+
+        if all(x is not None for x in child_bounds):
+            local_bounds = child_bounds[0]
+            for x in child_bounds[1:]:
+                local_bounds = local_bounds.union(x)
+
+            # Clip to the device pixels covered by the group (plus a pixel for anti-aliasing)
+            # so that cairo only allocates a surface of that size for the group.
+            matrix = render_context.get_matrix()
+            device_bounds = Bounds.from_points(geometry.to_device(local_bounds.corners, matrix))
+            render_context.identity_matrix()
+            render_context.rectangle(math.floor(device_bounds.x_min) - 1, math.floor(device_bounds.y_min) - 1,
+                                     math.ceil(device_bounds.width) + 3, math.ceil(device_bounds.height) + 3)
+
+            render_context.clip()
+            render_context.set_matrix(matrix)
+
+        render_context.push_group()
+        self._draw_children(render_context)
+        render_context.pop_group_to_source()
+        render_context.paint_with_alpha(self.opacity)
+
+    def _get_mask(self, render_context):
+        '''
+        Gets the clip mask of this group rasterized in device space, rasterizing it only if the mask,
+        the transformation or the visible region changed since it was last rasterized.
+
+        :returns:
+            A tuple containing an A8 :class:`cairo.ImageSurface` and the device coordinates of its
+            top-left corner, or ``None`` if the mask does not cover any visible pixels.
+
+        '''
+
+        matrix = render_context.get_matrix()
+        render_context.save()
+        render_context.identity_matrix()
+        x_min, y_min, x_max, y_max = render_context.clip_extents()
+        render_context.restore()
+
+        mask_bounds = self.clip_mask.bounds
+        if mask_bounds is not None:
+            # Expand by a pixel to include anti-aliased edges.
+            mask_bounds = Bounds.from_points(geometry.to_device(mask_bounds.corners, matrix)).expand(1)
+            x_min, y_min = max(x_min, mask_bounds.x_min), max(y_min, mask_bounds.y_min)
+            x_max, y_max = min(x_max, mask_bounds.x_max), min(y_max, mask_bounds.y_max)
+
+        x, y = math.floor(x_min), math.floor(y_min)
+        width, height = math.ceil(x_max) - x, math.ceil(y_max) - y
+        if width <= 0 or height <= 0: return None
+
+        # The cache is read once since the same group may be drawn by several threads.
+        cache = self._mask_cache
+        region = (tuple(matrix), x, y, width, height)
+        if cache is not None and cache[0] == region and cache[1] == _state_key(self.clip_mask):
+            return cache[2]
+
+        surface = cairo.ImageSurface(cairo.FORMAT_A8, width, height)
+        mask_context = cairo.Context(surface)
+        mask_context.translate(-x, -y)
+        mask_context.transform(matrix)
+        self.clip_mask.draw(mask_context)
+        surface.flush()
+
+        # The key is taken after drawing so that render caches built by the mask are included.
+        self._mask_cache = (region, _state_key(self.clip_mask), (surface, x, y))
+        return self._mask_cache[2]
+
+    def _draw_children(self, render_context, opacity=1):
+        '''
+        Draws the children of this group, multiplying their opacity by the specified factor.
+
+        :note:
+            The children are shared between threads when a frame is rasterized in tiles, so their
+            opacity is never changed here. A faded child is drawn as a shallow copy with the opacity
+            changed, which is given the render caches of the child (its transient attributes) and
+            hands back the caches that it builds.
+
+        '''
+
+        for child in self.children:
+            target = child
+            if opacity < 1:
+                target = copy.copy(child)
+                for name in child._transient_attributes:
+                    setattr(target, name, getattr(child, name, None))
+
+                target.opacity = child.opacity * opacity
+
+            # Isolate transformations using save/restore.
+            render_context.save()
+            target.draw(render_context)
+            render_context.restore()
+
+            if target is not child:
+                for name in child._transient_attributes:
+                    setattr(child, name, getattr(target, name, None))
+
+def _is_clip_rectangle(scene_object):
+    '''
+    Determines whether an object covers exactly its rectangular path, so that it can be used as a cairo clip.
+
+    '''
+
+    return isinstance(scene_object, Rectangle) and scene_object.border_radius == 0 and \
+           scene_object.stroke_colour is None and isinstance(scene_object.fill_colour, Color) and \
+           scene_object.opacity * scene_object.fill_opacity >= 1
+
+def _state_key(value):
+    '''
+    Gets a value that changes whenever the state of an object (or any value it holds) changes.
+
+    :note:
+        Arrays are compared by identity rather than by content, so building the key does not depend on
+        the size of the data. An array is considered changed when the attribute holding it is assigned
+        (as animations do), but not when it is modified in-place. Functions are also compared by
+        identity, since their state (e.g. their code and closure) is not held in ``__dict__``.
+
+    '''
+
+    if isinstance(value, np.ndarray):
+        return _Identity(value)
+
+    if isinstance(value, types.MethodType):
+        # A new bound method is created on every attribute access, so it is keyed by its parts.
+        return (_Identity(value.__func__), _Identity(value.__self__))
+
+    if isinstance(value, type):
+        return value
+
+    if callable(value):
+        return _Identity(value)
+
+    if isinstance(value, (list, tuple)):
+        return tuple(_state_key(x) for x in value)
+
+    if isinstance(value, dict):
+        return tuple((name, _state_key(x)) for name, x in value.items())
+
+    if isinstance(value, Color):
+        return value.rgb
+
+    if hasattr(value, '__getstate__') and hasattr(value, '__dict__'):
+        return (type(value), _state_key(value.__getstate__()))
+
+    if hasattr(value, '__dict__'):
+        return (type(value), _state_key(vars(value)))
+
+    return value
+
+class _Identity:
+    '''
+    A wrapper around a value that is only equal to a wrapper around the same value.
+
+    :note:
+        The wrapper holds a reference to the value so that its id cannot be reused by another value
+        while the wrapper is alive (e.g. in a cache key).
+
+    '''
+
+    __slots__ = ('value',)
+
+    def __init__(self, value):
+        self.value = value
+
+    def __eq__(self, other):
+        return isinstance(other, _Identity) and other.value is self.value
+
+    def __hash__(self):
+        return id(self.value)
+
+def _overlapping(bounds):
+    '''
+    Determines whether any two of the specified bounding boxes overlap using a sweep along the x-axis.
+    A bounding box of ``None`` (i.e. an unknown extent) is considered to overlap everything.
+
+    '''
+
+    if len(bounds) < 2: return False
+    if any(x is None for x in bounds): return True
+
+    active = []
+    for current in sorted(bounds, key=lambda x: x.x_min):
+        # Boxes that touch are overlapping, as in Bounds.intersects.
+        active = [x for x in active if x.x_max >= current.x_min]
+        if any(x.y_min <= current.y_max and current.y_min <= x.y_max for x in active):
+            return True
+
+        active.append(current)
+
+    return False
@@ -0,0 +1,430 @@
+import cv2
+import cairo
+import numpy as np
+
+def array_from_surface(surface):
+    '''
+    Gets a numpy view of the pixels of an ARGB32 :class:`cairo.ImageSurface`.
+
+    :note:
+        Cairo stores ARGB32 pixels as premultiplied 32-bit integers in native byte order, so on
+        little-endian machines the channels of the returned array are ordered blue, green, red, alpha.
+
+    :param surface:
+        The :class:`cairo.ImageSurface` whose pixels to view.
+    :returns:
+        A numpy array of bytes with shape ``(height, width, 4)`` sharing memory with the surface.
+
+    '''
+
+    surface.flush()
+    width, height, stride = surface.get_width(), surface.get_height(), surface.get_stride()
+    data = np.ndarray(shape=(height, stride // 4, 4), dtype=np.uint8, buffer=surface.get_data())
+    return data[:, :width]
+
+def surface_from_array(array):
+    '''
+    Creates an ARGB32 :class:`cairo.ImageSurface` that shares memory with a numpy array.
+
+    :note:
+        The array must be kept alive for as long as the surface is used.
+
+    :param array:
+        A C-contiguous numpy array of premultiplied BGRA bytes with shape ``(height, width, 4)``.
+    :returns:
+        A :class:`cairo.ImageSurface` backed by the array.
+
+    '''
+
+    height, width = array.shape[:2]
+    return cairo.ImageSurface.create_for_data(memoryview(array).cast('B'), cairo.FORMAT_ARGB32,
+                                              width, height, width * 4)
+
+def to_argb32(rgba, out=None):
+    '''
+    Converts premultiplied floating-point RGBA values to ARGB32 pixel data.
+
+    :param rgba:
+        A numpy array of premultiplied RGBA values from 0 to 1 with shape ``(..., 4)``.
+        Values outside this range are clamped.
+    :param out:
+        An optional C-contiguous numpy array of bytes with the same shape to write the pixels to.
+    :returns:
+        A numpy array of premultiplied BGRA bytes with the same shape as the input.
+
+    '''
+
+    if out is None:
+        out = np.empty(rgba.shape, dtype=np.uint8)
+
+    scaled = np.clip(rgba, 0, 1, dtype=np.float32)
+    scaled *= 255
+    scaled += 0.5
+    # Colour channels of a premultiplied pixel can never exceed its alpha.
+    np.minimum(scaled[..., :3], scaled[..., 3:], out=scaled[..., :3])
+
+    for source, destination in enumerate((2, 1, 0, 3)):
+        out[..., destination] = scaled[..., source]
+
+    return out
+
+def splat(points, radii, colours, width, height):
+    '''
+    Accumulates discs into an ARGB32 pixel buffer.
+
+    :note:
+        Colours are blended additively and each pixel within a disc receives the full colour of
+        the disc (i.e. there is no anti-aliasing). The buffer only covers the bounding box of the
+        discs that are visible, so the cost is proportional to the number of discs and the area
+        they cover rather than the size of the output.
+
+    :param points:
+        A numpy array with shape ``(n, 2)`` containing the centres of the discs in device space.
+    :param radii:
+        A numpy array with shape ``(n,)`` containing the radii of the discs in device pixels.
+    :param colours:
+        A numpy array with shape ``(n, 4)`` containing the (non-premultiplied) RGBA colours of the discs.
+    :param width:
+        The width of the device surface.
+    :param height:
+        The height of the device surface.
+    :returns:
+        A tuple containing the device-space coordinates of the top-left corner of the buffer and
+        a numpy array of premultiplied BGRA bytes with shape ``(buffer_height, buffer_width, 4)``
+        (see :func:`surface_from_array`), or ``None`` if no disc is visible.
+
+    '''
+
+    centres = np.floor(points).astype(np.int64)
+    extents = np.ceil(np.maximum(radii, 0.5)).astype(np.int64) - 1
+
+    visible = (centres[:, 0] + extents >= 0) & (centres[:, 0] - extents < width) & \
+              (centres[:, 1] + extents >= 0) & (centres[:, 1] - extents < height)
+    visible &= colours[:, 3] > 0
+    if not visible.any(): return None
+
+    centres, extents, radii = centres[visible], extents[visible], radii[visible]
+    premultiplied = colours[visible].astype(np.float32)
+    premultiplied[:, :3] *= premultiplied[:, 3:]
+
+    x_min = max(int((centres[:, 0] - extents).min()), 0)
+    y_min = max(int((centres[:, 1] - extents).min()), 0)
+    x_max = min(int((centres[:, 0] + extents).max()) + 1, width)
+    y_max = min(int((centres[:, 1] + extents).max()) + 1, height)
+    buffer_width, buffer_height = x_max - x_min, y_max - y_min
+
+    pixels, contributions = [], []
+    max_extent = int(extents.max())
+    for dy in range(-max_extent, max_extent + 1):
+        for dx in range(-max_extent, max_extent + 1):
+            # Only discs large enough to cover this offset contribute to it.
+            covered = np.flatnonzero((dx * dx + dy * dy <= np.maximum(radii * radii, 0.25)) &
+                                     (np.abs(dx) <= extents) & (np.abs(dy) <= extents))
+            if len(covered) == 0: continue
+
+            x = centres[covered, 0] + dx - x_min
+            y = centres[covered, 1] + dy - y_min
+            inside = (x >= 0) & (x < buffer_width) & (y >= 0) & (y < buffer_height)
+            if not inside.all():
+                covered, x, y = covered[inside], x[inside], y[inside]
+
+            pixels.append(y * buffer_width + x)
+            contributions.append(covered)
+
+    # Sum the contributions to each occupied pixel (rather than to every pixel in the buffer).
+    pixels, inverse = np.unique(np.concatenate(pixels), return_inverse=True)
+    contributions = premultiplied[np.concatenate(contributions)]
+
+    values = np.empty((len(pixels), 4), dtype=np.float32)
+    for channel in range(4):
+        values[:, channel] = np.bincount(inverse, weights=contributions[:, channel], minlength=len(pixels))
+
+    buffer = np.zeros((buffer_height * buffer_width, 4), dtype=np.uint8)
+    buffer[pixels] = to_argb32(values)
+    return (x_min, y_min), buffer.reshape(buffer_height, buffer_width, 4)
+
+def bin_points(points, x_min, y_min, width, height, values=None, out=None):
+    '''
+    Aggregates points into a grid of unit bins.
+
+    :param points:
+        A numpy array with shape ``(n, 2)`` containing the points in grid space (i.e. the point
+        ``(x, y)`` falls into the bin in column ``floor(x)`` and row ``floor(y)``).
+    :param x_min:
+        The column of the first bin.
+    :param y_min:
+        The row of the first bin.
+    :param width:
+        The number of columns of bins.
+    :param height:
+        The number of rows of bins.
+    :param values:
+        An optional numpy array with shape ``(n,)`` containing a value for each point.
+    :param out:
+        An optional tuple containing a C-contiguous numpy array of 64-bit integers with shape
+        ``(height, width)`` and, if values are given, a C-contiguous numpy array of floats with
+        the same shape, to write the counts and sums to.
+    :returns:
+        A tuple containing a numpy array with shape ``(height, width)`` of the number of points in
+        each bin and, if values are given, a numpy array of the same shape containing the sum of
+        the values in each bin (otherwise ``None``).
+
+    '''
+
+    cells = np.floor(points)
+    inside = (cells[:, 0] >= x_min) & (cells[:, 0] < x_min + width) & \
+             (cells[:, 1] >= y_min) & (cells[:, 1] < y_min + height)
+    if not inside.all():
+        cells = cells[inside]
+        if values is not None: values = values[inside]
+
+    ids = (cells[:, 1].astype(np.int64) - y_min) * width + (cells[:, 0].astype(np.int64) - x_min)
+    if out is None:
+        counts = np.bincount(ids, minlength=width * height).reshape(height, width)
+        if values is None: return counts, None
+
+        sums = np.bincount(ids, weights=values, minlength=width * height).reshape(height, width)
+        return counts, sums
+
+    # Accumulating into the existing buffers avoids allocating a buffer the size of the grid.
+    counts, sums = out
+    counts.fill(0)
+    np.add.at(counts.reshape(-1), ids, 1)
+    if values is None: return counts, None
+
+    sums.fill(0)
+    np.add.at(sums.reshape(-1), ids, values)
+    return counts, sums
+
+def colour_lut(colours, size=256):
+    '''
+    Creates a lookup table of ARGB32 pixels sampling the gradient formed by a list of colours.
+
+    :param colours:
+        A list of :class:`colour.Color` objects evenly spaced along the gradient.
+    :param size:
+        The number of entries in the table. Defaults to 256.
+    :returns:
+        A numpy array of (opaque) BGRA bytes with shape ``(size, 4)``.
+
+    '''
+
+    rgb = np.array([colour.rgb for colour in colours], dtype=np.float64).reshape(-1, 3)
+    stops = np.linspace(0, 1, len(rgb)) if len(rgb) > 1 else np.zeros(1)
+    samples = np.linspace(0, 1, size)
+
+    rgba = np.ones((size, 4), dtype=np.float32)
+    for channel in range(3):
+        rgba[:, channel] = np.interp(samples, stops, rgb[:, channel])
+
+    return to_argb32(rgba)
+
+def accumulate(accumulator, pixels):
+    '''
+    Adds ARGB32 pixel data to an accumulation buffer in-place.
+
+    :param accumulator:
+        A numpy array of unsigned 16-bit integers (for up to 256 additions, leaving room for the
+        rounding in :func:`average`) or 32-bit integers.
+    :param pixels:
+        A numpy array of bytes with the same shape as the accumulator.
+
+    '''
+
+    np.add(accumulator, pixels, out=accumulator, casting='unsafe')
+
+def average(accumulator, count, out=None):
+    '''
+    Divides an accumulation buffer by the number of accumulated buffers, with rounding.
+
+    :param accumulator:
+        A numpy array of accumulated pixel data (see :func:`accumulate`).
+    :param count:
+        The number of accumulated buffers.
+    :param out:
+        An optional numpy array of bytes with the same shape to write the result to.
+    :returns:
+        A numpy array of bytes with the same shape as the accumulator.
+
+    '''
+
+    if out is None:
+        out = np.empty(accumulator.shape, dtype=np.uint8)
+
+    accumulator += count // 2
+    np.floor_divide(accumulator, count, out=out, casting='unsafe')
+    return out
+
+def downsample(pixels, factor, out=None):
+    '''
+    Downsamples ARGB32 (or floating-point RGBA) pixel data by an integer factor using a box filter.
+
+    :note:
+        Since ARGB32 pixels are premultiplied, averaging the channels independently blends colours
+        correctly. The filter is OpenCV's area interpolation (whose fixed-point arithmetic may differ
+        from the rounded mean of a block by one level), which is vectorized and splits the rows
+        between threads (see :func:`cv2.setNumThreads`).
+
+    :param pixels:
+        A numpy array of premultiplied BGRA bytes (or RGBA 32-bit floats) with shape ``(height, width, 4)``.
+    :param factor:
+        The downsampling factor.
+    :param out:
+        An optional C-contiguous numpy array with the same type as the pixels and shape
+        ``(height // factor, width // factor, 4)`` to write the result to.
+    :returns:
+        A numpy array with the same type as the pixels and shape ``(height // factor, width // factor, 4)``.
+
+    '''
+
+    height, width = pixels.shape[0] // factor, pixels.shape[1] // factor
+    if out is None:
+        out = np.empty((height, width, 4), dtype=pixels.dtype)
+
+    pixels = pixels[:height * factor, :width * factor]
+    if factor == 1:
+        out[...] = pixels
+        return out
+
+    # The image is reduced in a single step, since reducing it in several steps (e.g. by halving)
+    # would round the result at each step.
+    cv2.resize(pixels, (width, height), dst=out, interpolation=cv2.INTER_AREA)
+    return out
+
+def high_precision_format():
+    '''
+    Gets the most precise image surface format supported by the installed version of cairo.
+
+    :returns:
+        ``cairo.FORMAT_RGBA128F`` (32-bit floats per channel, cairo 1.17.2 and later),
+        ``cairo.FORMAT_RGB30`` (10 bits per channel) or, failing both, ``cairo.FORMAT_ARGB32``.
+
+    '''
+
+    for name in ('RGBA128F', 'RGB30'):
+        surface_format = _format(name)
+        if surface_format is not None: return surface_format
+
+    return cairo.FORMAT_ARGB32
+
+def _format(name):
+    '''
+    Gets the cairo image format with the specified name, or ``None`` if it is not supported.
+
+    '''
+
+    # Newer formats are only exposed through the cairo.Format enumeration in some versions of pycairo.
+    return getattr(getattr(cairo, 'Format', None), name, getattr(cairo, 'FORMAT_' + name, None))
+
+def float_from_surface(surface, out=None):
+    '''
+    Gets the pixels of a :class:`cairo.ImageSurface` as premultiplied floating-point RGBA values.
+
+    :note:
+        The pixels of an RGBA128F surface are returned as a view (without copying).
+
+    :param surface:
+        An RGBA128F, RGB30 or ARGB32 :class:`cairo.ImageSurface`.
+    :param out:
+        An optional numpy array of 32-bit floats with shape ``(height, width, 4)`` to write the
+        pixels to (if they cannot be viewed).
+    :returns:
+        A numpy array of 32-bit floats from 0 to 1 with shape ``(height, width, 4)``.
+
+    '''
+
+    surface.flush()
+    surface_format = surface.get_format()
+    width, height, stride = surface.get_width(), surface.get_height(), surface.get_stride()
+    if surface_format == _format('RGBA128F'):
+        return np.ndarray(shape=(height, stride // 16, 4), dtype=np.float32, buffer=surface.get_data())[:, :width]
+
+    if out is None:
+        out = np.empty((height, width, 4), dtype=np.float32)
+
+    if surface_format == _format('RGB30'):
+        packed = np.ndarray(shape=(height, stride // 4), dtype=np.uint32, buffer=surface.get_data())[:, :width]
+        for channel, shift in enumerate((20, 10, 0)):
+            out[..., channel] = (packed >> shift) & 0x3FF
+
+        out[..., :3] *= 1 / 1023
+        out[..., 3] = 1
+    else:
+        pixels = array_from_surface(surface)
+        for source, destination in enumerate((2, 1, 0, 3)):
+            out[..., destination] = pixels[..., source]
+
+        out *= 1 / 255
+
+    return out
+
+class Quantizer:
+    '''
+    Converts floating-point RGBA frames to 8-bit BGR frames with ordered dithering.
+
+    :note:
+        Quantizing slow gradients to 8 bits produces visible bands; adding an 8x8 Bayer threshold
+        pattern before truncating breaks the bands up into a fine pattern that is invisible at
+        normal viewing distances.
+
+        The frame is converted in blocks of rows using buffers that are allocated once, so each
+        block is scaled, dithered, truncated and reordered while it is still in the cache.
+
+    '''
+
+    def __init__(self, width, height, dither=True, block_rows=64):
+        '''
+        Initializes an instance of :class:`Quantizer`.
+
+        :param width:
+            The width of the frames.
+        :param height:
+            The height of the frames.
+        :param dither:
+            Indicates whether ordered dithering should be applied. Defaults to ``True``.
+            Otherwise, values are rounded to the nearest 8-bit value.
+        :param block_rows:
+            The number of rows converted at a time. Defaults to 64.
+
+        '''
+
+        self.output = np.empty((height, width, 3), dtype=np.uint8)
+        self.block_rows = max(block_rows - block_rows % 8, 8)
+        self._scratch = np.empty((self.block_rows, width), dtype=np.float32)
+
+        if dither:
+            bayer = np.zeros((1, 1))
+            while len(bayer) < 8:
+                bayer = np.block([[4 * bayer, 4 * bayer + 2], [4 * bayer + 3, 4 * bayer + 1]])
+
+            threshold = (bayer + 0.5) / 64
+        else:
+            threshold = np.full((8, 8), 0.5)
+
+        # The threshold pattern is tiled over a block (blocks start on multiples of eight rows).
+        self._threshold = np.tile(threshold, (self.block_rows // 8, -(-width // 8)))[:, :width].astype(np.float32)
+
+    def __call__(self, rgba):
+        '''
+        Quantizes a frame.
+
+        :param rgba:
+            A numpy array of (opaque) floating-point RGBA values from 0 to 1 with shape ``(height, width, 4)``.
+        :returns:
+            A numpy array of BGR bytes with shape ``(height, width, 3)``. This buffer is reused
+            by the next call.
+
+        '''
+
+        height = len(self.output)
+        for start in range(0, height, self.block_rows):
+            end = min(start + self.block_rows, height)
+            scratch, threshold = self._scratch[:end - start], self._threshold[:end - start]
+            for source, destination in ((0, 2), (1, 1), (2, 0)):
+                np.multiply(rgba[start:end, :, source], 255, out=scratch)
+                scratch += threshold
+                np.clip(scratch, 0, 255, out=scratch)
+                # Casting truncates, so adding the threshold first rounds (or dithers) the value.
+                self.output[start:end, :, destination] = scratch
+
+        return self.output
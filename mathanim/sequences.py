@@ -7,6 +7,10 @@ class SequenceItem(ABC):
     
     '''
 
+    # Indicates whether evaluating the item is expensive enough that its values are worth
+    # keeping between renders (see :class:`mathanim.core.ValueCache`).
+    expensive = False
+
     @abstractmethod
     def get_value(self, time):
         '''
@@ -66,6 +70,15 @@ class Sequence(SequenceItem):
 
         return sum(item.duration for item in self.items)
 
+    @property
+    def expensive(self):
+        '''
+        Gets whether evaluating any item of the sequence is expensive.
+
+        '''
+
+        return any(item.expensive for item in self.items)
+
     def add(self, *sequence_items):
         '''
         Adds a list of sequence items to this sequence.
@@ -0,0 +1,173 @@
+import math
+
+class GridIndex:
+    '''
+    A spatial index over keyed bounding boxes backed by a uniform grid of cells.
+
+    :note:
+        Each box is registered in every cell it overlaps, so a query only visits the cells
+        overlapping the query box (or the occupied cells, if there are fewer of them) rather
+        than every box in the index. Boxes spanning more than ``max_cells`` cells, and keys
+        without bounds, are kept in separate lists that every query checks.
+
+        Query results are returned in the order that their keys were first inserted, which
+        makes the index suitable for preserving draw order.
+
+    '''
+
+    def __init__(self, cell_size=100, max_cells=256):
+        '''
+        Initializes an instance of :class:`GridIndex`.
+
+        :param cell_size:
+            The size of a cell of the grid. Defaults to 100.
+        :param max_cells:
+            The maximum number of cells that a box is registered in. Defaults to 256.
+
+        '''
+
+        self.cell_size = cell_size
+        self.max_cells = max_cells
+
+        self._cells = {}
+        self._entries = {}
+        self._oversized = set()
+        self._unbounded = set()
+        self._order = {}
+        self._counter = 0
+
+    def __len__(self):
+        return len(self._entries)
+
+    def __contains__(self, key):
+        return key in self._entries
+
+    def insert(self, key, bounds):
+        '''
+        Inserts a key into the index, or updates its bounds if it is already in the index.
+
+        :param key:
+            A hashable key.
+        :param bounds:
+            The :class:`mathanim.utils.Bounds` of the key. A value of ``None`` means that the
+            extent of the key is unknown, so it is returned by every query.
+
+        '''
+
+        self.update(key, bounds)
+
+    def update(self, key, bounds):
+        '''
+        Updates the bounds of a key, inserting it if it is not in the index.
+
+        :param key:
+            A hashable key.
+        :param bounds:
+            The new :class:`mathanim.utils.Bounds` of the key, or ``None`` if its extent is unknown.
+
+        '''
+
+        if key in self._entries:
+            previous, cells = self._entries[key]
+            if bounds is not None and previous is not None and cells is not None and \
+               self._cell_range(bounds) == cells:
+                # The key stays in the same cells; only its exact bounds change.
+                self._entries[key] = (bounds, cells)
+                return
+
+            self._unlink(key)
+        else:
+            self._order[key] = self._counter
+            self._counter += 1
+
+        cells = None
+        if bounds is None:
+            self._unbounded.add(key)
+        else:
+            cells = self._cell_range(bounds)
+            x_min, y_min, x_max, y_max = cells
+            if (x_max - x_min + 1) * (y_max - y_min + 1) > self.max_cells:
+                self._oversized.add(key)
+                cells = None
+            else:
+                for cell in _cells_in(cells):
+                    self._cells.setdefault(cell, set()).add(key)
+
+        self._entries[key] = (bounds, cells)
+
+    def remove(self, key):
+        '''
+        Removes a key from the index. Keys that are not in the index are ignored.
+
+        '''
+
+        if key not in self._entries: return
+
+        self._unlink(key)
+        del self._entries[key]
+        del self._order[key]
+
+    def query(self, bounds):
+        '''
+        Finds the keys whose bounds intersect the specified box.
+
+        :param bounds:
+            The :class:`mathanim.utils.Bounds` to query.
+        :returns:
+            A list of the intersecting keys (including keys without bounds) in insertion order.
+
+        '''
+
+        x_min, y_min, x_max, y_max = self._cell_range(bounds)
+        candidates = set()
+        if (x_max - x_min + 1) * (y_max - y_min + 1) <= len(self._cells):
+            for cell in _cells_in((x_min, y_min, x_max, y_max)):
+                keys = self._cells.get(cell)
+                if keys: candidates |= keys
+        else:
+            # The query covers more cells than are occupied, so visit the occupied cells instead.
+            for (x, y), keys in self._cells.items():
+                if x_min <= x <= x_max and y_min <= y <= y_max: candidates |= keys
+
+        candidates |= self._oversized
+        result = [key for key in candidates if self._entries[key][0].intersects(bounds)]
+        result.extend(self._unbounded)
+        result.sort(key=self._order.__getitem__)
+        return result
+
+    def _unlink(self, key):
+        '''
+        Removes a key from the cells (or lists) that it is registered in.
+
+        '''
+
+        _, cells = self._entries[key]
+        self._unbounded.discard(key)
+        self._oversized.discard(key)
+        if cells is None: return
+
+        for cell in _cells_in(cells):
+            keys = self._cells[cell]
+            keys.discard(key)
+            if not keys: del self._cells[cell]
+
+    def _cell_range(self, bounds):
+        '''
+        Gets the range of cells overlapped by a box as a tuple of the form ``(x_min, y_min, x_max, y_max)``.
+
+        '''
+
+        size = self.cell_size
+        return (math.floor(bounds.x_min / size), math.floor(bounds.y_min / size),
+                math.floor(bounds.x_max / size), math.floor(bounds.y_max / size))
+
+def _cells_in(cells):
+    '''
+    Iterates over the cells in a range of the form ``(x_min, y_min, x_max, y_max)``.
+
+    '''
+
+    x_min, y_min, x_max, y_max = cells
+    for y in range(y_min, y_max + 1):
+        for x in range(x_min, x_max + 1):
+            yield x, y
@@ -1,5 +1,6 @@
 import math
 import functools
+import numpy as np
 from colour import Color
 
 def rgetattr(obj, name, *args):
@@ -34,6 +35,23 @@ def rsetattr(obj, name, value):
     pre, _, post = name.rpartition('.')
     return setattr(rgetattr(obj, pre) if pre else obj, post, value)
 
+def values_equal(a, b):
+    '''
+    Determines whether two animated values are equal.
+
+    :note:
+        Unlike ``==``, this also compares numpy arrays (and values that cannot be compared) safely.
+
+    '''
+
+    if isinstance(a, np.ndarray) or isinstance(b, np.ndarray):
+        return a is not None and b is not None and np.array_equal(a, b)
+
+    try:
+        return bool(a == b)
+    except (TypeError, ValueError):
+        return False
+
 def convert_colour(value, keep_none=True):
     '''
     Converts a value to a :class:`colour.Color` object.
@@ -280,6 +298,118 @@ class Vector2:
     def __neg__(self): return Vector2(-self.x, -self.y)
     def __str__(self): return '({}, {})'.format(x, y)
 
+class Bounds:
+    '''
+    An axis-aligned bounding box.
+
+    '''
+
+    def __init__(self, x_min=0, y_min=0, x_max=0, y_max=0):
+        '''
+        Initializes an instance of :class:`Bounds`.
+
+        :param x_min:
+            The minimum x-coordinate of the box.
+        :param y_min:
+            The minimum y-coordinate of the box.
+        :param x_max:
+            The maximum x-coordinate of the box.
+        :param y_max:
+            The maximum y-coordinate of the box.
+
+        '''
+
+        self.x_min = x_min
+        self.y_min = y_min
+        self.x_max = x_max
+        self.y_max = y_max
+
+    @classmethod
+    def from_points(cls, points):
+        '''
+        Creates the smallest box containing the specified points.
+
+        :param points:
+            A numpy array of points with shape ``(n, 2)``. Non-finite points are ignored.
+        :returns:
+            A :class:`Bounds` object, or ``None`` if there are no finite points.
+
+        '''
+
+        points = points[np.isfinite(points).all(axis=1)]
+        if len(points) == 0: return None
+
+        x_min, y_min = points.min(axis=0).tolist()
+        x_max, y_max = points.max(axis=0).tolist()
+        return cls(x_min, y_min, x_max, y_max)
+
+    @property
+    def width(self):
+        '''
+        Gets the width of the box.
+
+        '''
+
+        return self.x_max - self.x_min
+
+    @property
+    def height(self):
+        '''
+        Gets the height of the box.
+
+        '''
+
+        return self.y_max - self.y_min
+
+    @property
+    def corners(self):
+        '''
+        Gets the corners of the box as a numpy array with shape ``(4, 2)``.
+
+        '''
+
+        return np.array([(self.x_min, self.y_min), (self.x_max, self.y_min),
+                         (self.x_max, self.y_max), (self.x_min, self.y_max)], dtype=np.float64)
+
+    def expand(self, amount):
+        '''
+        Gets a copy of this box grown by the specified amount on every side.
+
+        '''
+
+        return Bounds(self.x_min - amount, self.y_min - amount, self.x_max + amount, self.y_max + amount)
+
+    def intersects(self, other):
+        '''
+        Determines whether this box overlaps another :class:`Bounds`.
+
+        '''
+
+        return self.x_min <= other.x_max and other.x_min <= self.x_max and \
+               self.y_min <= other.y_max and other.y_min <= self.y_max
+
+    def contains(self, other):
+        '''
+        Determines whether this box contains another :class:`Bounds`.
+
+        '''
+
+        return self.x_min <= other.x_min and self.y_min <= other.y_min and \
+               self.x_max >= other.x_max and self.y_max >= other.y_max
+
+    def union(self, other):
+        '''
+        Gets the smallest box containing both this box and another :class:`Bounds`.
+
+        '''
+
+        return Bounds(min(self.x_min, other.x_min), min(self.y_min, other.y_min),
+                      max(self.x_max, other.x_max), max(self.y_max, other.y_max))
+
+    def __iter__(self): return iter((self.x_min, self.y_min, self.x_max, self.y_max))
+    def __eq__(self, other): return isinstance(other, Bounds) and tuple(self) == tuple(other)
+    def __str__(self): return '({}, {}, {}, {})'.format(*self)
+
 class BidirectionalMap(dict):
     '''
     A bidirectional dictionary. It supports key-value and value-key mapping.